@@ -1,2 +1,9 @@
+#include "../scripts/pixels.h"
+
+//Route every stb_image allocation through the reusable decode arena
+#define STBI_MALLOC(sz) util::decodeAlloc(sz)
+#define STBI_REALLOC(p, newsz) util::decodeRealloc(p, newsz)
+#define STBI_FREE(p) util::decodeFree(p)
+
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
\ No newline at end of file
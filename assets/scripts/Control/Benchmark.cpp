@@ -0,0 +1,259 @@
+#include <SDL.h>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <new>
+#include <atomic>
+#include <stdint.h>
+
+#include "../utils.h"
+#include "../GUI/AssetLoader.h"
+#include "../GUI/Archive.h"
+#include "../GUI/Profiler.h"
+#include "./Registry.h"
+#include "./LevelManager.h"
+#include "./Benchmark.h"
+
+#ifdef CHESS2_BENCH_ALLOC
+//Counts every operator new in the program, so the benchmark can report
+// allocations per frame. Defining these replaces the allocator for the whole
+// program, so every allocation pays an atomic increment. Only build benchmark
+// binaries with CHESS2_BENCH_ALLOC
+static std::atomic<uint64_t> allocationCount(0);
+
+void* operator new(std::size_t size) {
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	void* p = std::malloc(size == 0 ? 1 : size);
+	if (p == nullptr) throw std::bad_alloc();
+	return p;
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+static const bool COUNTING_ALLOCATIONS = true;
+static uint64_t allocations() { return allocationCount.load(std::memory_order_relaxed); }
+#else
+static const bool COUNTING_ALLOCATIONS = false;
+static uint64_t allocations() { return 0; }
+#endif
+
+//Define the Control namespace
+namespace ctrl {
+	//The levels benchmarked and where each is clicked. "std_chess" is the
+	// board view, which is reported as skipped until a level is registered
+	static const BenchScenario BENCH_SCENARIOS[] = {
+		{ "mainmenu", 0.5f, 0.73f }, //The play button
+		{ "gameselect", 0.5f, 0.5f }, //The std_chess button
+		{ "std_chess", -1, -1 }
+	};
+
+	//Writes a row of the report
+	static void report(const char* name, const BenchResult& result) {
+		std::printf("%-12s %8d %10.1f %10.3f %10.3f %12.2f ",
+			name, result.frames,
+			result.frames / result.seconds,
+			result.seconds * 1000.0 / result.frames,
+			result.worstMs,
+			(double)result.draws / result.frames);
+		if (COUNTING_ALLOCATIONS)
+			std::printf("%13.2f\n", (double)result.allocations / result.frames);
+		else std::printf("%13s\n", "n/a");
+	}
+
+	//Private
+	void Benchmark::moveMouse(int frame) {
+		//Trace a Lissajous curve over the middle 80% of the screen, which
+		// crosses every button on the menus on and off as it goes
+		double t = frame * 0.05;
+		int w = util::getScreenWidth(), h = util::getScreenHeight();
+		util::scriptMouse(
+			(int)(w / 2 + w * 0.4 * std::sin(t)),
+			(int)(h / 2 + h * 0.4 * std::sin(t * 1.5))
+		);
+	}
+
+	void Benchmark::frame(LevelManager* levels, bool click, BenchResult& result) {
+		GUI::Profiler& profiler = GUI::Profiler::instance();
+		uint64_t allocated = allocations();
+		uint64_t start = GUI::Profiler::now();
+		profiler.beginFrame();
+
+		profiler.beginPhase(GUI::PHASE_EVENTS);
+		if (click) levels->handleClick();
+		profiler.endPhase(GUI::PHASE_EVENTS);
+
+		profiler.beginPhase(GUI::PHASE_UPLOAD);
+		GUI::AssetLoader::instance().pump(this->renderer, GUI::UPLOADS_PER_FRAME);
+		profiler.endPhase(GUI::PHASE_UPLOAD);
+
+		profiler.beginPhase(GUI::PHASE_UPDATE);
+		levels->update();
+		profiler.endPhase(GUI::PHASE_UPDATE);
+
+		profiler.beginPhase(GUI::PHASE_RENDER);
+		SDL_SetRenderDrawColor(this->renderer,
+			util::BACKGROUND.r, util::BACKGROUND.g, util::BACKGROUND.b, 0xFF);
+		SDL_RenderClear(this->renderer);
+		levels->render();
+		profiler.endPhase(GUI::PHASE_RENDER);
+
+		profiler.beginPhase(GUI::PHASE_PRESENT);
+		SDL_RenderPresent(this->renderer);
+		profiler.endPhase(GUI::PHASE_PRESENT);
+
+		profiler.beginPhase(GUI::PHASE_TRANSITION);
+		levels->applyTransition();
+		profiler.endPhase(GUI::PHASE_TRANSITION);
+
+		profiler.endFrame();
+		uint64_t end = GUI::Profiler::now();
+
+		double ms = (double)(end - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+		result.frames++;
+		result.seconds += ms / 1000.0;
+		if (ms > result.worstMs) result.worstMs = ms;
+		result.draws += profiler.lastFrameDraws();
+		result.allocations += allocations() - allocated;
+	}
+
+	//Public
+	Benchmark::Benchmark() {
+		this->renderer = nullptr;
+		this->target = SDL_CreateRGBSurfaceWithFormat(0,
+			util::getScreenWidth(), util::getScreenHeight(), 32, SDL_PIXELFORMAT_ARGB8888);
+		if (this->target == nullptr) {
+			this->error = "Benchmark(): Surface could not be created";
+			return;
+		}
+		this->renderer = SDL_CreateSoftwareRenderer(this->target);
+		if (this->renderer == nullptr)
+			this->error = "Benchmark(): Software renderer could not be created";
+	}
+
+	Benchmark::~Benchmark() {
+		if (this->renderer != nullptr) SDL_DestroyRenderer(this->renderer);
+		if (this->target != nullptr) SDL_FreeSurface(this->target);
+	}
+
+	bool Benchmark::run(const BenchScenario& scenario, int frames,
+		BenchResult& steady, BenchResult& transition) {
+		steady = { 0, 0, 0, 0, 0 };
+		transition = { 0, 0, 0, 0, 0 };
+		if (this->renderer == nullptr) return false;
+
+		LevelID id = LevelRegistry::findLevel(scenario.level);
+		if (id == LVL_INVALID) {
+			this->error = "Benchmark.run(): No level registered as ";
+			this->error += scenario.level;
+			return false;
+		}
+
+		LevelManager* levels = new LevelManager(this->renderer);
+		if (!levels->open(id)) {
+			this->error = levels->getError();
+			delete levels;
+			return false;
+		}
+
+		//Run frames until every texture, including those of the prewarmed
+		// level, has been uploaded, so decoding is not measured
+		GUI::AssetLoader& loader = GUI::AssetLoader::instance();
+		util::scriptMouse(0, 0);
+		for (int x = 0; x < BENCH_WARMUP_FRAMES; x++) {
+			loader.pump(this->renderer, GUI::UPLOADS_PER_FRAME);
+			levels->update();
+			levels->render();
+			if (x > 0 && loader.pending() == 0) break;
+			SDL_Delay(1);
+		}
+
+		//Sweep the mouse over the level at rest
+		for (int x = 0; x < frames; x++) {
+			moveMouse(x);
+			this->frame(levels, false, steady);
+		}
+
+		//Hover over the click point for a frame so the button is in its
+		// hover pose, then click and follow the cross-fade to its end
+		if (scenario.clickX >= 0) {
+			util::scriptMouse(
+				(int)(scenario.clickX * util::getScreenWidth()),
+				(int)(scenario.clickY * util::getScreenHeight()));
+			BenchResult hover = { 0, 0, 0, 0, 0 };
+			this->frame(levels, false, hover);
+
+			Level* before = levels->getCurrent();
+			this->frame(levels, true, transition);
+			if (levels->getCurrent() == before) transition = { 0, 0, 0, 0, 0 };
+			for (int x = 0; x < BENCH_WARMUP_FRAMES && levels->isFading(); x++)
+				this->frame(levels, false, transition);
+		}
+
+		util::releaseMouse();
+		delete levels;
+		return true;
+	}
+
+	std::string Benchmark::getError() const { return this->error; }
+
+	int runBenchmarks(int frames) {
+		if (frames <= 0) {
+			std::cout << "runBenchmarks(): Frame count must be positive" << std::endl;
+			return 1;
+		}
+		if (SDL_Init(SDL_INIT_TIMER) < 0) {
+			std::cout << "SDL could not initialize" << std::endl;
+			std::cout << SDL_GetError() << std::endl;
+			return 1;
+		}
+
+		//Load textures the same way the game does
+		GUI::AssetArchive* archive = new GUI::AssetArchive();
+		if (archive->open("./assets/textures.pak"))
+			GUI::AssetLoader::instance().mount(archive);
+		LevelRegistry::registerBuiltins();
+
+		int code = 0;
+		Benchmark* bench = new Benchmark();
+		std::printf("%-12s %8s %10s %10s %10s %12s %13s\n", "level", "frames",
+			"fps", "ms/frame", "worst ms", "draws/frame", "allocs/frame");
+		for (size_t x = 0; x < sizeof(BENCH_SCENARIOS) / sizeof(BENCH_SCENARIOS[0]); x++) {
+			const BenchScenario& scenario = BENCH_SCENARIOS[x];
+
+			//Levels that have not been written yet are skipped, not failed
+			if (LevelRegistry::findLevel(scenario.level) == LVL_INVALID) {
+				std::printf("%-12s skipped, no level registered\n", scenario.level);
+				continue;
+			}
+
+			BenchResult steady, transition;
+			if (!bench->run(scenario, frames, steady, transition)) {
+				std::printf("%-12s failed: %s\n", scenario.level, bench->getError().c_str());
+				code = 1;
+				continue;
+			}
+			report(scenario.level, steady);
+
+			//Transitions are reported on a row of their own, as their first
+			// frame snapshots the outgoing level and is far from typical
+			if (scenario.clickX < 0) continue;
+			if (transition.frames == 0)
+				std::printf("%-12s none, the click did not change level\n", "  transition");
+			else report("  transition", transition);
+		}
+		std::fflush(stdout);
+		delete bench;
+
+		//Stop the decoding threads while SDL is still alive
+		GUI::AssetLoader::instance().shutdown();
+		GUI::AssetLoader::instance().mount(nullptr);
+		delete archive;
+		SDL_Quit();
+
+		return code;
+	}
+}
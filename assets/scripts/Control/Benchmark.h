@@ -0,0 +1,102 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <SDL.h>
+#include <iostream>
+#include <stdint.h>
+
+#include "./LevelManager.h"
+
+//Define the Control namespace
+namespace ctrl {
+
+	//The frames each level is measured over when none are given
+	static const int BENCH_FRAMES = 600;
+	//The most frames spent waiting for a level's textures before measuring,
+	// and the most spent waiting for a transition's cross-fade to finish
+	static const int BENCH_WARMUP_FRAMES = 2000;
+
+	/* A level to benchmark, and where the script clicks once it has been
+	*   measured. The click is given as fractions of the screen's size, and
+	*   is skipped IFF clickX < 0.
+	*/
+	struct BenchScenario {
+		const char* level; //The name the level is registered under
+		float clickX, clickY;
+	};
+
+	//The measurements of a run of frames
+	struct BenchResult {
+		int frames; //Frames measured
+		double seconds; //Wall time across them
+		double worstMs; //The slowest of them
+		uint64_t draws; //Draw calls made across them, see Profiler
+		uint64_t allocations; //operator new calls made across them
+	};
+
+	/* Renders levels without a display, for benchmarking on machines with no
+	*   screen. Each level is built by a LevelManager against a software
+	*   renderer drawing into an off-screen surface at the design size, so no
+	*   window or video driver is involved.
+	*
+	*  Once a level's textures have all been uploaded, input is replayed from
+	*   a fixed script through the same phases as the main loop. The mouse
+	*   first sweeps the screen along a fixed path for the requested number
+	*   of frames, hovering on and off the buttons, which measures the level
+	*   at rest. Then it clicks at the scenario's point, and the frames up to
+	*   the end of the resulting cross-fade are measured separately.
+	*
+	*  Allocations are only counted when built with CHESS2_BENCH_ALLOC, which
+	*   replaces operator new and delete for the whole program.
+	*/
+	class Benchmark {
+	private:
+		SDL_Surface* target; //The off-screen surface drawn into
+		SDL_Renderer* renderer;
+		std::string error;
+
+		//Places the scripted mouse for a frame of the sweep
+		static void moveMouse(int frame);
+
+		//Runs one frame of the main loop, clicking first IFF click is set,
+		// and adds its measurements to result
+		void frame(LevelManager* levels, bool click, BenchResult& result);
+
+	public:
+		//Creates the off-screen surface and its software renderer
+		Benchmark();
+		~Benchmark();
+
+		/*Runs one level through the benchmark
+		*
+		* Precondition:
+		* - The levels have been registered
+		*
+		* Params:
+		* - scenario - the level, and where to click once it is measured
+		* - frames - the number of frames to sweep the mouse for, > 0
+		* - steady - receives the measurements of the sweep
+		* - transition - receives the measurements from the click to the end
+		*   of the cross-fade, and has no frames IFF the click did not change
+		*   the level
+		*
+		* Returns true IFF the level exists and was measured, false OW
+		*/
+		bool run(const BenchScenario& scenario, int frames,
+			BenchResult& steady, BenchResult& transition);
+
+		//Accesses the most recent error
+		std::string getError() const;
+	};
+
+	/*Runs every benchmarked level and writes a report to stdout
+	*
+	* Params:
+	* - frames - the number of frames each level is measured over
+	*
+	* Returns the exit code, 0 IFF every available level was measured
+	*/
+	int runBenchmarks(int frames);
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include "../GUI/Displayable.h"
 #include "../GUI/Layering.h"
 #include "./Level.h"
+#include "./Registry.h"
 
 using GUI::Displayable;
 using GUI::Button;
@@ -15,30 +16,29 @@ using std::string;
 //Define the Control namespace
 namespace ctrl {
 	void mainMenu::handleClick() {
-		SDL_GetMouseState(
+		util::getMouseState(
 			&(this->mx),
 			&(this->my)
 		);
 
-		Button* playbutton = (Button*)(this->assets.getAssetByKey("play_button"));
-		if (playbutton->collidepoint(this->mx, this->my)) {
-			this->state = "goto gameselect";
+		if (this->assets.hitTest(this->mx, this->my) == this->playButton) {
+			this->state = { TRANS_GOTO, LevelRegistry::findLevel("gameselect") };
 		}
 
 		return;
 	}
 
 	void mainMenu::update() {
-		SDL_GetMouseState(
+		util::getMouseState(
 			&(this->mx),
 			&(this->my)
 		);
 
-		Button* playbutton = (Button*)(this->assets.getAssetByKey("play_button"));
-		if (playbutton->collidepoint(this->mx, this->my)) {
-			playbutton->setPose("hover");
+		Button* playbutton = (Button*)(this->assets.getAsset(this->playButton));
+		if (this->assets.hitTest(this->mx, this->my) == this->playButton) {
+			playbutton->setPose(this->hoverPose);
 		} else {
-			playbutton->setPose("neutral");
+			playbutton->setPose(this->neutralPose);
 		}
 
 		return;
@@ -50,36 +50,52 @@ namespace ctrl {
 		return;
 	}
 
+	LevelID mainMenu::likelyNext() const {
+		return LevelRegistry::findLevel("gameselect");
+	}
+
 
 	void gameSelect::handleClick() {
-		SDL_GetMouseState(&this->mx, &this->my);
-
-		for (string key : this->assets.getKeys()) {
-			Button* btn = (Button*)(this->assets.getAssetByKey(key));
-			if (btn->collidepoint(this->mx, this->my)) {
-				if (btn->getFlag() == util::ANONYMOUS) {
-					std::cout << "gameSelect.handleClick(): Button flag not set";
-					std::cout << std::endl;
-					continue;
-				}
-				this->state = "goto " + btn->getFlag();
-			}
+		util::getMouseState(&this->mx, &this->my);
+
+		//Find the button under the mouse, if any
+		Displayable* hit = this->assets.getAsset(
+			this->assets.hitTest(this->mx, this->my));
+		if (hit == nullptr || hit->getType() != GUI::DISP_BUTTON) return;
+		Button* btn = static_cast<Button*>(hit);
+
+		if (btn->getFlagID() == util::STR_ANONYMOUS) {
+			std::cout << "gameSelect.handleClick(): Button flag not set";
+			std::cout << std::endl;
+			return;
+		}
+		LevelID target = LevelRegistry::findLevel(btn->getFlagID());
+		if (target == LVL_INVALID) {
+			std::cout << "gameSelect.handleClick(): No level registered as ";
+			std::cout << btn->getFlag() << std::endl;
+			return;
 		}
+		this->state = { TRANS_GOTO, target };
 
 		return;
 	}
 
 	void gameSelect::update() {
-		SDL_GetMouseState(&this->mx, &this->my);
-
-		for (string key : this->assets.getKeys()) {
-			Button* btn = (Button*)(this->assets.getAssetByKey(key));
-			if (btn->collidepoint(this->mx, this->my)) {
-				btn->setPose("hover");
-			} else {
-				btn->setPose("neutral");
-			}
-		}
+		util::getMouseState(&this->mx, &this->my);
+
+		//Only the buttons entering or leaving the hover need new poses
+		GUI::AssetHandle hit = this->assets.hitTest(this->mx, this->my);
+		if (hit == this->hovered) return;
+
+		Displayable* prev = this->assets.getAsset(this->hovered);
+		if (prev != nullptr && prev->getType() == GUI::DISP_BUTTON)
+			static_cast<Button*>(prev)->setPose(this->neutralPose);
+
+		Displayable* next = this->assets.getAsset(hit);
+		if (next != nullptr && next->getType() == GUI::DISP_BUTTON)
+			static_cast<Button*>(next)->setPose(this->hoverPose);
+
+		this->hovered = hit;
 
 		return;
 	}
@@ -89,4 +105,10 @@ namespace ctrl {
 			std::cout << this->assets.getError() << std::endl;
 		return;
 	}
+
+	LevelID gameSelect::likelyNext() const {
+		//Standard chess is the only mode so far. Until its board level is
+		// registered this finds nothing and no level is prewarmed
+		return LevelRegistry::findLevel("std_chess");
+	}
 }
\ No newline at end of file
@@ -7,8 +7,10 @@
 #include <vector>
 #include <stdint.h>
 
+#include "../intern.h"
 #include "../GUI/Displayable.h"
 #include "../GUI/Layering.h"
+#include "./Registry.h"
 
 //Define the Control namespace
 namespace ctrl {
@@ -17,106 +19,152 @@ namespace ctrl {
 	protected:
 		SDL_Renderer* renderer = nullptr;
 		GUI::PegBar assets;
-		std::string state;
+		Transition state;
 		int mx, my;
 
+		//Interned names of the poses shared by every level's buttons
+		util::StrID hoverPose, neutralPose;
+
 	public:
+		Level() {
+			this->hoverPose = util::intern("hover");
+			this->neutralPose = util::intern("neutral");
+		}
+		virtual ~Level() {}
+
 		virtual void handleClick() = 0;
 		virtual void update() = 0;
 		virtual void render() = 0;
-		std::string getState() { return this->state; }
+
+		/*Adapts the level to a new screen size. By default this repositions
+		*  every asset that has a Layout.
+		*
+		* Params:
+		* - width - the new width of the screen in pixels
+		* - height - the new height of the screen in pixels
+		*/
+		virtual void resize(int width, int height) { this->assets.resize(width, height); }
+
+		/*Redraws everything the level keeps in render targets after the
+		*  renderer has lost their contents. See PegBar::resetTargets().
+		*
+		* Params:
+		* - recreate - whether the device was lost, so the target textures
+		*   themselves must be created afresh
+		*/
+		virtual void resetTargets(bool recreate) { this->assets.resetTargets(recreate); }
+
+		/*Names the level the player is most likely to go to from this one, so
+		*  the LevelManager can build it ahead of time
+		*
+		* Returns the LevelID of the likely next level, LVL_INVALID IFF there
+		*  is no obvious choice
+		*/
+		virtual LevelID likelyNext() const { return LVL_INVALID; }
+
+		//Accesses the transition this level is requesting of the main loop
+		const Transition& getState() const { return this->state; }
+
+		//Discards any pending transition request
+		void clearState() { this->state = { TRANS_NONE, LVL_INVALID }; }
 	};
 
 	class mainMenu : public Level {
+	private:
+		GUI::AssetHandle playButton; //The handle of the play button
+
 	public:
 		mainMenu(SDL_Renderer* renderer) {
 			//Store the current renderer
 			this->renderer = renderer;
 
 			//Store the initial mouse position
-			this->mx = util::SCREEN_WIDTH / 2;
-			this->my = util::SCREEN_HEIGHT / 2;
-			SDL_GetMouseState(&(this->mx), &(this->my));
+			this->mx = util::getScreenWidth() / 2;
+			this->my = util::getScreenHeight() / 2;
+			util::getMouseState(&(this->mx), &(this->my));
 
 			//Initialize the state to an empty value
-			this->state = util::ANONYMOUS;
-
-			//Insert the icon into the asset structure
-			this->assets.insertIntoLayer(
-				"icon",
-				new GUI::Displayable(
-					renderer, "./assets/texture/screens/main-menu.png",
-					{ 0, 0, util::SCREEN_WIDTH, util::SCREEN_HEIGHT }),
-				0);
-
-			GUI::Button* playbutton =
-				new GUI::Button({
-					util::SCREEN_WIDTH / 2 - (267 / 2),
-					util::SCREEN_HEIGHT / 3 * 2,
-					267, 92
-					},
-					"play");
-			playbutton->givePose(
+			this->clearState();
+
+			//The background never changes, so it sits on a cached layer of its
+			// own beneath the button
+			this->assets.makeLayer(1);
+			this->assets.setLayerStatic(0, true);
+
+			//Insert the icon into the asset structure, its texture is decoded
+			// in the background
+			GUI::Displayable* icon = new GUI::Displayable();
+			icon->setLayout(GUI::Layout::relative(0, 0, 0, 0, 1, 1));
+			icon->loadTexture("./assets/texture/screens/main-menu.png");
+			this->assets.insertIntoLayer("icon", icon, 0);
+
+			//Centre the play button horizontally, two thirds of the way down
+			GUI::Button* playbutton = new GUI::Button("play");
+			playbutton->setLayout(GUI::Layout::fixed(0.5f, 2.0f / 3, 0.5f, 0, 267, 92));
+			playbutton->queuePose(
 				"hover",
-				"./assets/texture/buttons/play/hover.png",
-				this->renderer
+				"./assets/texture/buttons/play/hover.png"
 				);
-			playbutton->givePose(
+			playbutton->queuePose(
 				"neutral",
-				"./assets/texture/buttons/play/neutral.png",
-				this->renderer
+				"./assets/texture/buttons/play/neutral.png"
 				);
+			playbutton->setPose(this->neutralPose);
 			this->assets.insertIntoLayer(
 				"play_button",
 				playbutton,
-				0
+				1
 				);
+			this->playButton = this->assets.getHandle("play_button");
 		}
 		~mainMenu() {}
 
 		void handleClick();
 		void update();
 		void render();
+		LevelID likelyNext() const;
 	};
 
 	class gameSelect : public Level {
+	private:
+		//The handle of the button currently under the mouse, if any
+		GUI::AssetHandle hovered;
+
 	public:
 		gameSelect(SDL_Renderer* renderer) {
 			//Store the current renderer
 			this->renderer = renderer;
 
 			//Store the current mouse position
-			this->mx = util::SCREEN_WIDTH / 2;
-			this->my = util::SCREEN_HEIGHT / 2;
-			SDL_GetMouseState(&this->mx, &this->my);
+			this->mx = util::getScreenWidth() / 2;
+			this->my = util::getScreenHeight() / 2;
+			util::getMouseState(&this->mx, &this->my);
 
 			//Initialize the state to nothing
-			this->state = util::ANONYMOUS;
-
-			GUI::Button* std_chess =
-				new GUI::Button({
-				util::SCREEN_WIDTH / 2 - (216 / 2),
-				util::SCREEN_HEIGHT / 2 - (216 / 2),
-				216, 216 },
-				"std_chess"
-				);
-			std_chess->givePose(
+			this->clearState();
+
+			GUI::Button* std_chess = new GUI::Button("std_chess");
+			std_chess->setLayout(GUI::Layout::fixed(0.5f, 0.5f, 0.5f, 0.5f, 216, 216));
+			std_chess->queuePose(
 				"neutral",
-				"./assets/texture/buttons/std_chess/neutral.png",
-				this->renderer
+				"./assets/texture/buttons/std_chess/neutral.png"
 				);
-			std_chess->givePose(
+			std_chess->queuePose(
 				"hover",
-				"./assets/texture/buttons/std_Chess/hover.png",
-				this->renderer
+				"./assets/texture/buttons/std_chess/hover.png"
 				);
+			std_chess->setPose(this->neutralPose);
 			this->assets.insertIntoLayer("std_chess", std_chess, 0);
+
+			//Nothing is hovered until the first update
+			this->hovered = GUI::ASSET_NULL;
 		}
 		~gameSelect() {};
 
 		void handleClick();
 		void update();
 		void render();
+		LevelID likelyNext() const;
 	};
 }
 
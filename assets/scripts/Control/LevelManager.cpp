@@ -0,0 +1,167 @@
+#include <SDL.h>
+#include <iostream>
+#include <stdint.h>
+
+#include "../utils.h"
+#include "./Level.h"
+#include "./Registry.h"
+#include "./LevelManager.h"
+
+//Define the Control namespace
+namespace ctrl {
+	//Private
+	bool LevelManager::snapshot() {
+		//Create the texture the first time it is needed
+		if (this->fadeTex == nullptr) {
+			this->fadeTex = SDL_CreateTexture(
+				this->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+				util::getScreenWidth(), util::getScreenHeight());
+			if (this->fadeTex == nullptr) return false;
+			SDL_SetTextureBlendMode(this->fadeTex, SDL_BLENDMODE_BLEND);
+		}
+
+		//Draw the level into the texture exactly as it appears on screen
+		SDL_Texture* target = SDL_GetRenderTarget(this->renderer);
+		if (SDL_SetRenderTarget(this->renderer, this->fadeTex) != 0) return false;
+		SDL_SetRenderDrawColor(this->renderer,
+			util::BACKGROUND.r, util::BACKGROUND.g, util::BACKGROUND.b, 0xFF);
+		SDL_RenderClear(this->renderer);
+		this->current->render();
+		SDL_SetRenderTarget(this->renderer, target);
+
+		return true;
+	}
+
+	//Public
+	bool LevelManager::open(LevelID id) {
+		if (id == LVL_INVALID) {
+			this->error = "LevelManager.open(): Level not registered";
+			return false;
+		}
+		Level* lvl = LevelRegistry::create(id, this->renderer);
+		if (lvl == nullptr) {
+			this->error = "LevelManager.open(): Level could not be built";
+			return false;
+		}
+
+		delete this->current;
+		this->current = lvl;
+		this->currentID = id;
+		this->prewarmed = false;
+		this->fading = false;
+		return true;
+	}
+
+	bool LevelManager::prewarm(LevelID id) {
+		if (this->next != nullptr && this->nextID == id) return true;
+
+		Level* lvl = LevelRegistry::create(id, this->renderer);
+		if (lvl == nullptr) return false;
+
+		delete this->next;
+		this->next = lvl;
+		this->nextID = id;
+		return true;
+	}
+
+	bool LevelManager::switchTo(LevelID id) {
+		//Take the prewarmed level if it is the one wanted, build it OW
+		Level* lvl = nullptr;
+		if (this->next != nullptr && this->nextID == id) {
+			lvl = this->next;
+			this->next = nullptr;
+			this->nextID = LVL_INVALID;
+		} else {
+			lvl = LevelRegistry::create(id, this->renderer);
+			if (lvl == nullptr) return false;
+		}
+
+		//Capture the outgoing level for the fade before it is destroyed
+		this->fading = false;
+		if (this->current != nullptr && this->fadeLength > 0 && this->snapshot()) {
+			this->fading = true;
+			this->fadeStart = SDL_GetTicks();
+		}
+
+		delete this->current;
+		this->current = lvl;
+		this->currentID = id;
+		this->prewarmed = false;
+		return true;
+	}
+
+	bool LevelManager::applyTransition() {
+		if (this->current == nullptr) return true;
+
+		const Transition& next = this->current->getState();
+		if (next.type == TRANS_QUIT) return false;
+		if (next.type == TRANS_GOTO && !this->switchTo(next.target)) {
+			std::cout << "LevelManager.applyTransition(): level not registered";
+			std::cout << std::endl;
+			this->current->clearState();
+		}
+		return true;
+	}
+
+	void LevelManager::setFadeLength(Uint32 ms) { this->fadeLength = ms; }
+
+	bool LevelManager::isFading() const { return this->fading; }
+
+	void LevelManager::handleClick() {
+		if (this->current != nullptr) this->current->handleClick();
+	}
+
+	void LevelManager::update() {
+		if (this->current == nullptr) return;
+		this->current->update();
+
+		//Build the likely next level now that this one has had a frame
+		if (!this->prewarmed) {
+			this->prewarmed = true;
+			LevelID likely = this->current->likelyNext();
+			if (likely != LVL_INVALID) this->prewarm(likely);
+		}
+	}
+
+	void LevelManager::render() {
+		if (this->current == nullptr) return;
+		this->current->render();
+
+		//Blend the outgoing level over the incoming one as it fades away
+		if (!this->fading) return;
+		Uint32 elapsed = SDL_GetTicks() - this->fadeStart;
+		if (elapsed >= this->fadeLength) {
+			this->fading = false;
+			return;
+		}
+		Uint8 alpha = (Uint8)(255 - (255 * elapsed) / this->fadeLength);
+		SDL_SetTextureAlphaMod(this->fadeTex, alpha);
+		SDL_RenderCopy(this->renderer, this->fadeTex, NULL, NULL);
+	}
+
+	void LevelManager::resize(int width, int height) {
+		if (this->current != nullptr) this->current->resize(width, height);
+		if (this->next != nullptr) this->next->resize(width, height);
+
+		//The snapshot is recreated at the new size by the next fade
+		this->fading = false;
+		if (this->fadeTex != nullptr) SDL_DestroyTexture(this->fadeTex);
+		this->fadeTex = nullptr;
+	}
+
+	void LevelManager::resetTargets(bool recreate) {
+		if (this->current != nullptr) this->current->resetTargets(recreate);
+		if (this->next != nullptr) this->next->resetTargets(recreate);
+
+		//The snapshot cannot be retaken, so the fade ends here
+		this->fading = false;
+		if (recreate && this->fadeTex != nullptr) {
+			SDL_DestroyTexture(this->fadeTex);
+			this->fadeTex = nullptr;
+		}
+	}
+
+	Level* LevelManager::getCurrent() { return this->current; }
+
+	std::string LevelManager::getError() const { return this->error; }
+}
\ No newline at end of file
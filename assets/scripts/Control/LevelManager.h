@@ -0,0 +1,137 @@
+#ifndef LEVELMANAGER_H
+#define LEVELMANAGER_H
+
+#include <SDL.h>
+#include <iostream>
+#include <stdint.h>
+
+#include "./Level.h"
+#include "./Registry.h"
+
+//Define the Control namespace
+namespace ctrl {
+
+	//The default length of the cross-fade between levels, in milliseconds
+	static const Uint32 FADE_MS = 250;
+
+	/* Owns the level on screen and carries out the transitions it requests.
+	*   While a level is showing, the manager builds the level it expects to
+	*   come next (see Level::likelyNext()) so that its textures decode in the
+	*   background. When the transition comes, switching is a pointer exchange.
+	*
+	*  Transitions can cross-fade. The outgoing level is drawn once into an
+	*   off-screen texture, which is then blended over the incoming level with
+	*   a falling alpha. Nothing is decoded or re-rendered for the fade.
+	*/
+	class LevelManager {
+	private:
+		SDL_Renderer* renderer;
+
+		Level* current; //The level being shown
+		LevelID currentID;
+		Level* next; //The prewarmed level, nullptr if there is none
+		LevelID nextID;
+		bool prewarmed; //Whether the current level has had its successor built
+
+		SDL_Texture* fadeTex; //Snapshot of the outgoing level
+		bool fading;
+		Uint32 fadeStart, fadeLength;
+
+		std::string error;
+
+		//Draws the current level into fadeTex. Returns false IFF the renderer
+		// cannot render to textures
+		bool snapshot();
+
+	public:
+		LevelManager(SDL_Renderer* renderer) {
+			this->renderer = renderer;
+
+			this->current = nullptr;
+			this->currentID = LVL_INVALID;
+			this->next = nullptr;
+			this->nextID = LVL_INVALID;
+			this->prewarmed = false;
+
+			this->fadeTex = nullptr;
+			this->fading = false;
+			this->fadeStart = 0;
+			this->fadeLength = FADE_MS;
+		}
+
+		//Destroys every level held, along with the fade texture
+		~LevelManager() {
+			delete this->current;
+			delete this->next;
+			if (this->fadeTex != nullptr) SDL_DestroyTexture(this->fadeTex);
+		}
+
+		/*Switches to a level straight away, without fading
+		*
+		* Returns true IFF the level is registered and was opened, false OW
+		*/
+		bool open(LevelID id);
+
+		/*Builds a level ahead of time so a later switch to it is instant. Any
+		*  other prewarmed level is discarded.
+		*
+		* Returns true IFF the level is registered and was built, false OW
+		*/
+		bool prewarm(LevelID id);
+
+		/*Switches to a level, cross-fading from the current one IFF a fade
+		*  length is set and the renderer supports render targets. Uses the
+		*  prewarmed level when it matches.
+		*
+		* Returns true IFF the level is registered and is now current, false OW
+		*/
+		bool switchTo(LevelID id);
+
+		/*Acts on the transition requested by the current level
+		*
+		* Returns false IFF the level asked the game to quit, true OW
+		*/
+		bool applyTransition();
+
+		/*Sets the length of future cross-fades
+		*
+		* Params:
+		* - ms - the fade length in milliseconds, 0 disables fading
+		*/
+		void setFadeLength(Uint32 ms);
+
+		//Checks whether a cross-fade is in progress
+		bool isFading() const;
+
+		/*Forward the frame's work to the current level. update() also builds
+		*  the current level's likely successor, one frame after it is shown.
+		*  render() draws any cross-fade in progress on top.
+		*/
+		void handleClick();
+		void update();
+		void render();
+
+		/*Adapts the current and prewarmed levels to a new screen size. Any
+		*  cross-fade in progress is cut short, as its snapshot no longer fits.
+		*/
+		void resize(int width, int height);
+
+		/*Adapts the current and prewarmed levels to the renderer losing the
+		*  contents of its render targets. Any cross-fade in progress is cut
+		*  short, as its snapshot is gone and the outgoing level with it.
+		*
+		* Params:
+		* - recreate - whether the device was lost, so the target textures
+		*   themselves must be created afresh (SDL_RENDER_DEVICE_RESET)
+		*/
+		void resetTargets(bool recreate);
+
+		//Accesses the level being shown
+		Level* getCurrent();
+
+		//Accesses the most recent error
+		std::string getError() const;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include <SDL.h>
+#include <iostream>
+#include <vector>
+#include <stdint.h>
+
+#include "../intern.h"
+#include "./Level.h"
+#include "./Registry.h"
+
+using std::string;
+
+//Define the Control namespace
+namespace ctrl {
+	//Private
+	std::vector<LevelRegistry::Entry>& LevelRegistry::entries() {
+		static std::vector<Entry> table;
+		return table;
+	}
+
+	//Public
+	LevelID LevelRegistry::registerLevel(const string& name, LevelFactory factory) {
+		//Ensure there is a factory to store
+		if (factory == nullptr) return LVL_INVALID;
+		//Ensure the name is not already in use
+		util::StrID id = util::intern(name);
+		if (findLevel(id) != LVL_INVALID) return LVL_INVALID;
+
+		//Append the entry, its index becomes its ID
+		entries().push_back({ id, factory });
+		return (LevelID)(entries().size() - 1);
+	}
+
+	LevelID LevelRegistry::findLevel(const string& name) {
+		return findLevel(util::findInterned(name));
+	}
+
+	LevelID LevelRegistry::findLevel(util::StrID name) {
+		if (name == util::STR_INVALID) return LVL_INVALID;
+		std::vector<Entry>& table = entries();
+		for (size_t x = 0; x < table.size(); x++)
+			if (table[x].name == name) return (LevelID)x;
+		return LVL_INVALID;
+	}
+
+	Level* LevelRegistry::create(LevelID id, SDL_Renderer* renderer) {
+		if (id < 0 || (size_t)id >= entries().size()) return nullptr;
+		return entries()[id].factory(renderer);
+	}
+
+	void LevelRegistry::registerBuiltins() {
+		//Register each level that ships with the game. New levels only need
+		// an entry here (named after the Button flag that leads to them)
+		registerLevel("mainmenu", makeLevel<mainMenu>);
+		registerLevel("gameselect", makeLevel<gameSelect>);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <SDL.h>
+#include <iostream>
+#include <vector>
+#include <stdint.h>
+
+#include "../intern.h"
+
+//Define the Control namespace
+namespace ctrl {
+
+	class Level;
+
+	//Identifies a level registered in the LevelRegistry
+	typedef int16_t LevelID;
+	static const LevelID LVL_INVALID = -1;
+
+	//The kinds of requests a level can make of the main loop
+	enum TransitionType {
+		TRANS_NONE,
+		TRANS_GOTO,
+		TRANS_QUIT
+	};
+
+	/* A request raised by a Level for the main loop to act on. The target is
+	*   only meaningful when type == TRANS_GOTO.
+	*/
+	struct Transition {
+		TransitionType type;
+		LevelID target;
+	};
+
+	//Builds a fresh instance of a registered level
+	typedef Level* (*LevelFactory)(SDL_Renderer* renderer);
+
+	//Generic factory for any level constructible from a renderer
+	template <class T>
+	Level* makeLevel(SDL_Renderer* renderer) { return new T(renderer); }
+
+	/* This class maps level names onto factories so that the main loop can
+	*   construct the next level from a Transition without knowing its type.
+	*   Names are resolved to LevelIDs once (at construction or on a click),
+	*   so per-frame transition checks never touch a string.
+	*/
+	class LevelRegistry {
+	private:
+		struct Entry {
+			util::StrID name;
+			LevelFactory factory;
+		};
+
+		//Accesses the table of registered levels, indexed by LevelID
+		static std::vector<Entry>& entries();
+
+	public:
+		/*Registers a level under the provided name
+		*
+		* Preconditions:
+		* - name cannot already be registered
+		* - factory != nullptr
+		*
+		* Params:
+		* - name - the string used to look the level up (e.g. a Button flag)
+		* - factory - the function that constructs the level
+		*
+		* Returns the LevelID of the new entry IFF it was registered,
+		*  LVL_INVALID OW
+		*/
+		static LevelID registerLevel(const std::string& name, LevelFactory factory);
+
+		/*Finds the LevelID associated with a name
+		*
+		* Returns the LevelID IFF name is registered, LVL_INVALID OW
+		*/
+		static LevelID findLevel(const std::string& name);
+		static LevelID findLevel(util::StrID name);
+
+		/*Constructs a new instance of the level associated with id
+		*
+		* Precondition:
+		* - renderer != nullptr
+		*
+		* Returns a pointer to the new Level IFF id is registered, nullptr OW
+		*/
+		static Level* create(LevelID id, SDL_Renderer* renderer);
+
+		/*Registers every level that ships with the game. Safe to call more
+		*  than once.
+		*/
+		static void registerBuiltins();
+	};
+}
+
+#endif
\ No newline at end of file
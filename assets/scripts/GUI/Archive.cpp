@@ -0,0 +1,178 @@
+#include <SDL.h>
+#include <iostream>
+#include <map>
+#include <string>
+#include <cstring>
+#include <stdint.h>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+#include "../intern.h"
+#include "./Archive.h"
+
+namespace GUI {
+	//Private
+	bool AssetArchive::validate() {
+		if (this->size < sizeof(ArchiveHeader)) return false;
+
+		this->header = (const ArchiveHeader*)this->base;
+		if (std::memcmp(this->header->magic, ARCHIVE_MAGIC, 4) != 0) return false;
+		if (this->header->version != ARCHIVE_VERSION) return false;
+
+		//Ensure the tables fit in the file
+		uint64_t tables = sizeof(ArchiveHeader)
+			+ (uint64_t)this->header->pageCount * sizeof(ArchivePage)
+			+ (uint64_t)this->header->entryCount * sizeof(ArchiveEntry);
+		if (tables > this->size) return false;
+		this->pages = (const ArchivePage*)(this->base + sizeof(ArchiveHeader));
+		this->entries = (const ArchiveEntry*)(this->pages + this->header->pageCount);
+
+		//Ensure every page's pixels fit in the file
+		for (uint32_t x = 0; x < this->header->pageCount; x++) {
+			const ArchivePage& page = this->pages[x];
+			if (page.pitch < (uint64_t)page.width * 4) return false;
+			if (page.offset > this->size) return false;
+			if ((uint64_t)page.pitch * page.height > this->size - page.offset) return false;
+		}
+
+		//Ensure every entry lies within its page and has a terminated name
+		for (uint32_t x = 0; x < this->header->entryCount; x++) {
+			const ArchiveEntry& entry = this->entries[x];
+			if (entry.page >= this->header->pageCount) return false;
+			if (entry.name[ARCHIVE_NAME_LEN - 1] != '\0') return false;
+			const ArchivePage& page = this->pages[entry.page];
+			if (entry.x < 0 || entry.y < 0 || entry.w <= 0 || entry.h <= 0) return false;
+			//Summed in 64 bits, as a corrupt rect could overflow an int32_t
+			if ((uint64_t)entry.x + (uint64_t)entry.w > page.width) return false;
+			if ((uint64_t)entry.y + (uint64_t)entry.h > page.height) return false;
+		}
+
+		return true;
+	}
+
+	//Public
+	bool AssetArchive::open(const char* path) {
+		this->close();
+
+		//Map the whole file read-only
+		#ifdef _WIN32
+			HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+				OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (file == INVALID_HANDLE_VALUE) {
+				this->error = "AssetArchive.open(): Cannot open file";
+				return false;
+			}
+			LARGE_INTEGER length;
+			GetFileSizeEx(file, &length);
+			HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+			if (view == NULL) {
+				if (mapping) CloseHandle(mapping);
+				CloseHandle(file);
+				this->error = "AssetArchive.open(): Cannot map file";
+				return false;
+			}
+			this->file = file;
+			this->mapping = mapping;
+			this->base = (const uint8_t*)view;
+			this->size = (size_t)length.QuadPart;
+		#else
+			int file = ::open(path, O_RDONLY);
+			if (file < 0) {
+				this->error = "AssetArchive.open(): Cannot open file";
+				return false;
+			}
+			struct stat info;
+			void* view = MAP_FAILED;
+			if (fstat(file, &info) == 0 && info.st_size > 0)
+				view = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, file, 0);
+			if (view == MAP_FAILED) {
+				::close(file);
+				this->error = "AssetArchive.open(): Cannot map file";
+				return false;
+			}
+			this->file = file;
+			this->base = (const uint8_t*)view;
+			this->size = (size_t)info.st_size;
+		#endif
+
+		if (!this->validate()) {
+			this->close();
+			this->error = "AssetArchive.open(): Not a valid archive";
+			return false;
+		}
+
+		//Index the entries by name
+		for (uint32_t x = 0; x < this->header->entryCount; x++)
+			this->names[util::intern(this->entries[x].name)] = x;
+
+		return true;
+	}
+
+	void AssetArchive::close() {
+		if (this->base != nullptr) {
+			#ifdef _WIN32
+				UnmapViewOfFile(this->base);
+				CloseHandle(this->mapping);
+				CloseHandle(this->file);
+				this->mapping = nullptr;
+				this->file = nullptr;
+			#else
+				munmap((void*)this->base, this->size);
+				::close(this->file);
+				this->file = -1;
+			#endif
+		}
+
+		this->base = nullptr;
+		this->size = 0;
+		this->header = nullptr;
+		this->pages = nullptr;
+		this->entries = nullptr;
+		this->names.clear();
+	}
+
+	bool AssetArchive::isOpen() const { return this->base != nullptr; }
+
+	int32_t AssetArchive::find(const char* path) const {
+		if (!this->isOpen()) return -1;
+
+		//Entries are stored without the leading "./"
+		if (path[0] == '.' && path[1] == '/') path += 2;
+
+		util::StrID id = util::internTable().find(path, std::strlen(path));
+		std::map<util::StrID, uint32_t>::const_iterator i = this->names.find(id);
+		if (i == this->names.end()) return -1;
+		return (int32_t)i->second;
+	}
+
+	SDL_Texture* AssetArchive::createTexture(SDL_Renderer* renderer, int32_t entry) const {
+		const ArchiveEntry& info = this->entries[entry];
+		const ArchivePage& page = this->pages[info.page];
+
+		SDL_Texture* texture = SDL_CreateTexture(renderer, this->header->pixelFormat,
+			SDL_TEXTUREACCESS_STATIC, info.w, info.h);
+		if (texture == nullptr) return nullptr;
+
+		//Point SDL at the entry's rect within the mapped page. The page pitch
+		// lets it step over the neighbouring images without a copy
+		const uint8_t* pixels = this->base + page.offset
+			+ (size_t)info.y * page.pitch + (size_t)info.x * 4;
+		if (SDL_UpdateTexture(texture, NULL, pixels, page.pitch) != 0) {
+			SDL_DestroyTexture(texture);
+			return nullptr;
+		}
+		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+		return texture;
+	}
+
+	std::string AssetArchive::getError() const { return this->error; }
+}
\ No newline at end of file
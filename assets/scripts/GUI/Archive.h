@@ -0,0 +1,137 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <SDL.h>
+#include <iostream>
+#include <map>
+#include <string>
+#include <stdint.h>
+
+#include "../intern.h"
+
+namespace GUI {
+
+	/* On-disk layout of a texture archive, as written by tools/assetpack.cpp.
+	*   All fields are little-endian. The file starts with an ArchiveHeader,
+	*   followed by the page table and the entry table. The pixels of each page
+	*   start on a 4096-byte boundary so they can be used straight from a
+	*   memory mapping.
+	*
+	*  Pages are atlases of pre-decoded pixels in the header's SDL pixel
+	*   format. Each entry names one source image and the rect it occupies
+	*   in a page.
+	*/
+	static const char ARCHIVE_MAGIC[4] = { 'C', '2', 'P', 'K' };
+	static const uint32_t ARCHIVE_VERSION = 1;
+	static const uint32_t ARCHIVE_ALIGN = 4096;
+	static const int ARCHIVE_NAME_LEN = 108;
+
+	struct ArchiveHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t pixelFormat; //An SDL_PIXELFORMAT_* value, 4 bytes per pixel
+		uint32_t pageCount;
+		uint32_t entryCount;
+		uint32_t reserved;
+	};
+
+	struct ArchivePage {
+		uint32_t width, height;
+		uint32_t pitch; //Bytes per row of pixels
+		uint32_t reserved;
+		uint64_t offset; //Where the pixels start, from the start of the file
+	};
+
+	struct ArchiveEntry {
+		char name[ARCHIVE_NAME_LEN]; //The image's path, without a leading "./"
+		uint32_t page;
+		int32_t x, y, w, h; //The image's rect within the page
+	};
+
+	//The layout is shared with the packer, so keep it free of padding surprises
+	static_assert(sizeof(ArchiveHeader) == 24, "ArchiveHeader layout changed");
+	static_assert(sizeof(ArchivePage) == 24, "ArchivePage layout changed");
+	static_assert(sizeof(ArchiveEntry) == 128, "ArchiveEntry layout changed");
+
+	/* A read-only view of a texture archive. The file is memory-mapped, so
+	*   opening it costs no decoding or copying, and creating a texture hands
+	*   SDL a pointer straight into the mapped page.
+	*/
+	class AssetArchive {
+	private:
+		const uint8_t* base; //The start of the mapping, nullptr while closed
+		size_t size;
+		#ifdef _WIN32
+			void* file;
+			void* mapping;
+		#else
+			int file;
+		#endif
+
+		const ArchiveHeader* header;
+		const ArchivePage* pages;
+		const ArchiveEntry* entries;
+
+		//Maps each interned entry name onto its index in entries
+		std::map<util::StrID, uint32_t> names;
+
+		std::string error;
+
+		//Checks that the tables and pixel ranges all lie within the file
+		bool validate();
+
+	public:
+		AssetArchive() {
+			this->base = nullptr;
+			this->size = 0;
+			#ifdef _WIN32
+				this->file = nullptr;
+				this->mapping = nullptr;
+			#else
+				this->file = -1;
+			#endif
+			this->header = nullptr;
+			this->pages = nullptr;
+			this->entries = nullptr;
+			this->error = "";
+		}
+		~AssetArchive() { this->close(); }
+
+		/*Maps an archive into memory and indexes its entries
+		*
+		* Postcondition:
+		* - Any previously opened archive is closed
+		*
+		* Returns true IFF the file exists and is a valid archive, false OW
+		*/
+		bool open(const char* path);
+
+		//Unmaps the archive. Textures already created are unaffected
+		void close();
+
+		//Checks whether an archive is open
+		bool isOpen() const;
+
+		/*Finds the entry for an image path. A leading "./" is ignored, so
+		*  the same paths used with util::LoadTexture can be looked up.
+		*
+		* Returns the index of the entry IFF the image is in the archive, -1 OW
+		*/
+		int32_t find(const char* path) const;
+
+		/*Creates a texture from an entry, uploading directly from the mapping
+		*
+		* Preconditions:
+		* - renderer != nullptr
+		* - 0 <= entry < the number of entries
+		*
+		* Returns the new texture IFF it was created, nullptr OW
+		*/
+		SDL_Texture* createTexture(SDL_Renderer* renderer, int32_t entry) const;
+
+		//Accesses the most recent error that has occurred in this archive
+		std::string getError() const;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include <SDL.h>
+#include <iostream>
+#include <vector>
+#include <stdint.h>
+
+#include "../intern.h"
+#include "./AssetIndex.h"
+
+using util::StrID;
+using util::STR_INVALID;
+
+namespace GUI {
+	//Private
+	size_t AssetIndex::home(StrID key) const {
+		//Fibonacci hashing spreads the sequential intern IDs across the table
+		return (size_t)((key * 2654435769u) >> (32 - this->bits));
+	}
+
+	size_t AssetIndex::probe(StrID key) const {
+		size_t mask = this->cells.size() - 1;
+		size_t i = this->home(key);
+		while (this->cells[i].key != STR_INVALID && this->cells[i].key != key)
+			i = (i + 1) & mask;
+		return i;
+	}
+
+	void AssetIndex::grow() {
+		std::vector<Cell> old;
+		old.swap(this->cells);
+
+		this->bits++;
+		this->cells.assign((size_t)1 << this->bits, { STR_INVALID, ASSET_NULL });
+		for (size_t x = 0; x < old.size(); x++)
+			if (old[x].key != STR_INVALID)
+				this->cells[this->probe(old[x].key)] = old[x];
+	}
+
+	//Public
+	bool AssetIndex::insert(StrID key, AssetHandle handle) {
+		if (key == STR_INVALID) return false;
+		size_t i = this->probe(key);
+		if (this->cells[i].key == key) return false;
+
+		this->cells[i] = { key, handle };
+		this->count++;
+
+		//Keep the load factor at or below three quarters
+		if (this->count * 4 > this->cells.size() * 3) this->grow();
+		return true;
+	}
+
+	AssetHandle AssetIndex::find(StrID key) const {
+		if (key == STR_INVALID) return ASSET_NULL;
+		size_t i = this->probe(key);
+		if (this->cells[i].key != key) return ASSET_NULL;
+		return this->cells[i].handle;
+	}
+
+	bool AssetIndex::erase(StrID key) {
+		if (key == STR_INVALID) return false;
+		size_t mask = this->cells.size() - 1;
+		size_t i = this->probe(key);
+		if (this->cells[i].key != key) return false;
+
+		//Shift back any following entries that would no longer be reachable
+		// once this cell is emptied
+		size_t j = i;
+		while (true) {
+			j = (j + 1) & mask;
+			if (this->cells[j].key == STR_INVALID) break;
+
+			size_t k = this->home(this->cells[j].key);
+			bool movable = (j > i) ? (k <= i || k > j) : (k <= i && k > j);
+			if (movable) {
+				this->cells[i] = this->cells[j];
+				i = j;
+			}
+		}
+
+		this->cells[i].key = STR_INVALID;
+		this->count--;
+		return true;
+	}
+
+	size_t AssetIndex::size() const { return this->count; }
+}
\ No newline at end of file
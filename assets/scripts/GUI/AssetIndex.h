@@ -0,0 +1,89 @@
+#ifndef ASSETINDEX_H
+#define ASSETINDEX_H
+
+#include <SDL.h>
+#include <iostream>
+#include <vector>
+#include <stdint.h>
+
+#include "../intern.h"
+
+namespace GUI {
+
+	/* A stable reference to an asset stored in a PegBar. The handle stays
+	*   valid while the asset is in the structure, regardless of layers being
+	*   made, dropped or reordered. Once the asset is removed its slot's
+	*   generation is bumped, so stale handles are detected instead of
+	*   silently resolving to whatever reuses the slot.
+	*/
+	struct AssetHandle {
+		uint32_t index; //The slot in the PegBar's asset table
+		uint32_t generation; //Must match the slot's generation to be valid
+	};
+	static const AssetHandle ASSET_NULL = { 0xFFFFFFFF, 0 };
+
+	inline bool operator==(AssetHandle a, AssetHandle b) {
+		return a.index == b.index && a.generation == b.generation;
+	}
+	inline bool operator!=(AssetHandle a, AssetHandle b) { return !(a == b); }
+
+	/* An open-addressing hash table mapping interned asset keys onto their
+	*   handle in a PegBar. Cells are probed linearly and removed with
+	*   backward-shift deletion, so there are no tombstones and lookups stay
+	*   O(1) no matter how many assets have come and gone.
+	*/
+	class AssetIndex {
+	private:
+		struct Cell {
+			util::StrID key; //STR_INVALID marks an empty cell
+			AssetHandle handle;
+		};
+
+		std::vector<Cell> cells;
+		size_t count;
+		uint8_t bits; //cells.size() == 1 << bits
+
+		//Finds the preferred cell for a key
+		size_t home(util::StrID key) const;
+
+		//Finds the cell holding key, or the empty cell where it would go
+		size_t probe(util::StrID key) const;
+
+		//Doubles the cell count and reinserts every entry
+		void grow();
+
+	public:
+		AssetIndex() {
+			this->bits = 5;
+			this->cells.assign((size_t)1 << this->bits, { util::STR_INVALID, ASSET_NULL });
+			this->count = 0;
+		}
+
+		/*Associates a key with a handle
+		*
+		* Precondition:
+		* - key != util::STR_INVALID
+		*
+		* Returns true IFF the key was not already present and was inserted,
+		*  false OW
+		*/
+		bool insert(util::StrID key, AssetHandle handle);
+
+		/*Finds the handle associated with a key
+		*
+		* Returns the stored handle IFF key is present, ASSET_NULL OW
+		*/
+		AssetHandle find(util::StrID key) const;
+
+		/*Removes a key from the index
+		*
+		* Returns true IFF the key was present and removed, false OW
+		*/
+		bool erase(util::StrID key);
+
+		//Finds the number of keys in the index
+		size_t size() const;
+	};
+}
+
+#endif
\ No newline at end of file
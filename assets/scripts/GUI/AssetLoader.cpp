@@ -0,0 +1,177 @@
+#include <SDL.h>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
+
+#include "../utils.h"
+#include "../intern.h"
+#include "../pixels.h"
+#include "./Displayable.h"
+#include "./Archive.h"
+#include "./AssetLoader.h"
+
+namespace GUI {
+	//Private
+	void AssetLoader::work() {
+		std::unique_lock<std::mutex> guard(this->lock);
+		while (true) {
+			//Sleep until there is something to decode or the pool is stopping
+			this->wake.wait(guard, [this] {
+				return this->stopping || !this->queued.empty();
+			});
+			if (this->stopping) return;
+
+			Job* job = this->queued.front();
+			this->queued.pop_front();
+			if (job->cancelled) {
+				discard(job);
+				continue;
+			}
+			this->active.push_back(job);
+
+			//Decode without holding the lock so other workers can proceed
+			guard.unlock();
+			job->pixels.load(job->path.c_str());
+			guard.lock();
+
+			//Hand the job over for upload, unless its target went away
+			for (int x = 0; x < this->active.size(); x++) {
+				if (this->active[x] != job) continue;
+				this->active[x] = this->active.back();
+				this->active.pop_back();
+				break;
+			}
+			if (job->cancelled) discard(job);
+			else this->finished.push_back(job);
+		}
+	}
+
+	void AssetLoader::discard(Job* job) {
+		delete job;
+	}
+
+	//Public
+	AssetLoader& AssetLoader::instance() {
+		static AssetLoader loader;
+		return loader;
+	}
+
+	void AssetLoader::start(unsigned threads) {
+		std::lock_guard<std::mutex> guard(this->lock);
+		if (!this->workers.empty()) return;
+
+		//Leave a hardware thread free for the render loop
+		if (threads == 0) {
+			unsigned hardware = std::thread::hardware_concurrency();
+			threads = (hardware > 1) ? hardware - 1 : 1;
+		}
+
+		this->stopping = false;
+		for (unsigned x = 0; x < threads; x++)
+			this->workers.push_back(std::thread(&AssetLoader::work, this));
+	}
+
+	void AssetLoader::shutdown() {
+		//Wake every worker and wait for them to exit
+		{
+			std::lock_guard<std::mutex> guard(this->lock);
+			this->stopping = true;
+		}
+		this->wake.notify_all();
+		for (int x = 0; x < this->workers.size(); x++)
+			this->workers[x].join();
+		this->workers.clear();
+
+		//Nothing is running now, so the queues can be emptied freely
+		for (int x = 0; x < this->queued.size(); x++) discard(this->queued[x]);
+		for (int x = 0; x < this->finished.size(); x++) discard(this->finished[x]);
+		this->queued.clear();
+		this->finished.clear();
+	}
+
+	void AssetLoader::mount(const AssetArchive* archive) { this->archive = archive; }
+
+	void AssetLoader::request(const char* path, Displayable* target, util::StrID tag) {
+		Job* job = new Job();
+		job->path = path;
+		job->target = target;
+		job->tag = tag;
+		job->cancelled = false;
+		job->entry = (this->archive != nullptr) ? this->archive->find(path) : -1;
+
+		//Archived images are ready to upload as they are
+		if (job->entry >= 0) {
+			std::lock_guard<std::mutex> guard(this->lock);
+			this->finished.push_back(job);
+			return;
+		}
+
+		if (this->workers.empty()) this->start(0);
+		{
+			std::lock_guard<std::mutex> guard(this->lock);
+			this->queued.push_back(job);
+		}
+		this->wake.notify_one();
+	}
+
+	void AssetLoader::cancel(Displayable* target) {
+		std::lock_guard<std::mutex> guard(this->lock);
+
+		//Flag the jobs rather than freeing them, as a worker may hold one
+		for (int x = 0; x < this->queued.size(); x++)
+			if (this->queued[x]->target == target) this->queued[x]->cancelled = true;
+		for (int x = 0; x < this->active.size(); x++)
+			if (this->active[x]->target == target) this->active[x]->cancelled = true;
+		for (int x = 0; x < this->finished.size(); x++)
+			if (this->finished[x]->target == target) this->finished[x]->cancelled = true;
+	}
+
+	int AssetLoader::pump(SDL_Renderer* renderer, int budget) {
+		int delivered = 0;
+
+		while (delivered < budget) {
+			//Take the next decoded job, if there is one
+			Job* job = nullptr;
+			{
+				std::lock_guard<std::mutex> guard(this->lock);
+				if (this->finished.empty()) break;
+				job = this->finished.front();
+				this->finished.pop_front();
+			}
+			if (job->cancelled) {
+				discard(job);
+				continue;
+			}
+
+			//Upload the pixels, then give the texture to its Displayable. A
+			// failed load still notifies the target so it can stop waiting
+			SDL_Texture* texture = nullptr;
+			if (job->entry >= 0 && this->archive != nullptr)
+				texture = this->archive->createTexture(renderer, job->entry);
+			else {
+				const util::Pixels& pixels = job->pixels;
+				SDL_Surface* surface = util::makeSurface(pixels.getData(),
+					pixels.getWidth(), pixels.getHeight(), pixels.getBytesPerPixel());
+				if (surface != nullptr) {
+					texture = SDL_CreateTextureFromSurface(renderer, surface);
+					SDL_FreeSurface(surface);
+				}
+			}
+			job->target->receiveTexture(job->tag, texture);
+
+			discard(job);
+			delivered++;
+		}
+
+		return delivered;
+	}
+
+	size_t AssetLoader::pending() const {
+		std::lock_guard<std::mutex> guard(this->lock);
+		return this->queued.size() + this->active.size() + this->finished.size();
+	}
+}
\ No newline at end of file
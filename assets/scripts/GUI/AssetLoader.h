@@ -0,0 +1,135 @@
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include <SDL.h>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
+
+#include "../intern.h"
+#include "../pixels.h"
+#include "./Archive.h"
+
+namespace GUI {
+
+	class Displayable;
+
+	//The default number of textures uploaded to the renderer per frame
+	static const int UPLOADS_PER_FRAME = 4;
+
+	/* Decodes images on a pool of worker threads so that building a level
+	*   never stalls the window. Workers only run stb_image and produce CPU
+	*   pixels; the SDL_Texture upload happens on the render thread inside
+	*   pump(), which caps how many uploads a single frame may perform.
+	*
+	*  When an AssetArchive is mounted, images found in it skip decoding
+	*   entirely and are uploaded straight from the mapped archive.
+	*
+	*  Each request names a Displayable and a tag (a pose name for Buttons).
+	*   When the texture is ready it is handed over through
+	*   Displayable::receiveTexture(). Until then, the Displayable draws a
+	*   placeholder.
+	*/
+	class AssetLoader {
+	private:
+		struct Job {
+			std::string path;
+			Displayable* target;
+			util::StrID tag;
+			bool cancelled; //Set when the target is destroyed mid-flight
+
+			int32_t entry; //The image's archive entry, -1 if it is decoded from disk
+			util::Pixels pixels; //Decoded pixels, empty until decoded
+		};
+
+		const AssetArchive* archive; //The mounted archive, nullptr if none
+
+		std::vector<std::thread> workers;
+		mutable std::mutex lock;
+		std::condition_variable wake;
+		bool stopping;
+
+		std::deque<Job*> queued; //Waiting for a worker
+		std::vector<Job*> active; //Being decoded by a worker
+		std::deque<Job*> finished; //Decoded, waiting for upload
+
+		//The loop run by every worker thread
+		void work();
+
+		//Frees a job along with any pixels it holds
+		static void discard(Job* job);
+
+		AssetLoader() {
+			this->stopping = false;
+			this->archive = nullptr;
+		}
+
+	public:
+		~AssetLoader() { this->shutdown(); }
+
+		//Accesses the process-wide loader
+		static AssetLoader& instance();
+
+		/*Starts the worker threads. Called automatically by the first request,
+		*  so it only needs calling directly to choose the thread count.
+		*
+		* Params:
+		* - threads - the number of workers, 0 picks one fewer than the
+		*   number of hardware threads (at least one)
+		*/
+		void start(unsigned threads);
+
+		/*Stops and joins the worker threads, discarding all outstanding
+		*  requests. Must be called before SDL is shut down.
+		*/
+		void shutdown();
+
+		/*Serves future requests from an archive where it holds the image.
+		*  Pass nullptr to go back to decoding everything from disk.
+		*
+		* Preconditions:
+		* - archive must stay open until it is unmounted or the loader is
+		*   shut down
+		*/
+		void mount(const AssetArchive* archive);
+
+		/*Queues an image to be decoded and delivered to a Displayable
+		*
+		* Preconditions:
+		* - target != nullptr
+		* - target must call cancel() before it is destroyed
+		*
+		* Params:
+		* - path - the location of the image being loaded
+		* - target - the Displayable that receives the texture
+		* - tag - passed back to the target along with the texture
+		*/
+		void request(const char* path, Displayable* target, util::StrID tag);
+
+		/*Drops every outstanding request for a Displayable, so nothing is
+		*  delivered to it afterwards.
+		*/
+		void cancel(Displayable* target);
+
+		/*Uploads decoded images to the renderer and hands the textures to
+		*  their Displayables. Must be called from the render thread, usually
+		*  once per frame.
+		*
+		* Params:
+		* - renderer - the renderer the textures are created for
+		* - budget - the most textures that may be uploaded by this call
+		*
+		* Returns the number of textures delivered
+		*/
+		int pump(SDL_Renderer* renderer, int budget);
+
+		//Finds the number of requests that have not yet been delivered
+		size_t pending() const;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include <SDL.h>
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <stdint.h>
+
+#include "./Displayable.h"
+#include "./Canvas.h"
+
+//Define the GUI namespace
+namespace GUI {
+	//Private
+	bool Canvas::touch(const SDL_Rect& area, SDL_Rect& clipped) {
+		SDL_Rect bounds = { 0, 0, this->canvasW, this->canvasH };
+		if (!SDL_IntersectRect(&area, &bounds, &clipped)) return false;
+
+		SDL_UnionRect(&this->dirty, &clipped, &this->dirty);
+		return true;
+	}
+
+	bool Canvas::upload(SDL_Texture* texture, const SDL_Rect& area) {
+		void* dst;
+		int pitch;
+		if (SDL_LockTexture(texture, &area, &dst, &pitch) != 0) return false;
+
+		//The locked pixels start at the area's top-left corner
+		const uint32_t* src = &this->pixels[(size_t)area.y * this->canvasW + area.x];
+		for (int row = 0; row < area.h; row++) {
+			std::memcpy((uint8_t*)dst + (size_t)row * pitch,
+				src + (size_t)row * this->canvasW, (size_t)area.w * 4);
+		}
+
+		SDL_UnlockTexture(texture);
+		return true;
+	}
+
+	//Public
+	Canvas::Canvas(SDL_Renderer* renderer, int width, int height) :
+		Canvas(renderer, width, height, { 0, 0, width, height }) {}
+
+	Canvas::Canvas(SDL_Renderer* renderer, int width, int height, SDL_Rect pos) :
+		Displayable(pos), pixels((size_t)width * height, 0) {
+		this->type = DISP_CANVAS;
+		//The buffers change every frame, so a resized copy would go stale
+		this->prescale = false;
+
+		this->canvasW = width;
+		this->canvasH = height;
+		this->front = 0;
+		this->locked = false;
+
+		//Start both buffers transparent so either can be shown first
+		SDL_Rect all = { 0, 0, width, height };
+		for (int x = 0; x < 2; x++) {
+			this->buffers[x] = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+				SDL_TEXTUREACCESS_STREAMING, width, height);
+			if (this->buffers[x] == nullptr || !this->upload(this->buffers[x], all)) {
+				this->error = "Canvas(): Streaming texture could not be created";
+				continue;
+			}
+			SDL_SetTextureBlendMode(this->buffers[x], SDL_BLENDMODE_BLEND);
+		}
+		this->dirty = { 0, 0, 0, 0 };
+		this->backStale = { 0, 0, 0, 0 };
+
+		this->img = this->buffers[this->front];
+	}
+
+	Canvas::~Canvas() {
+		for (int x = 0; x < 2; x++)
+			if (this->buffers[x] != nullptr) SDL_DestroyTexture(this->buffers[x]);
+		//img is one of the buffers, so keep ~Displayable from destroying it twice
+		this->img = nullptr;
+	}
+
+	uint32_t Canvas::color(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+		return ((uint32_t)a << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+	}
+
+	uint32_t* Canvas::lock(const SDL_Rect& area, int* pitch) {
+		if (this->locked) {
+			this->error = "Canvas.lock(): Canvas is already locked";
+			return nullptr;
+		}
+
+		//Only whole areas can be locked, as the caller writes area.w pixels
+		// into every row
+		if (area.x < 0 || area.y < 0 || area.w <= 0 || area.h <= 0
+			|| area.x + area.w > this->canvasW || area.y + area.h > this->canvasH) {
+			this->error = "Canvas.lock(): Area is not on the canvas";
+			return nullptr;
+		}
+		SDL_Rect clipped;
+		this->touch(area, clipped);
+
+		this->locked = true;
+		*pitch = this->canvasW;
+		return &this->pixels[(size_t)clipped.y * this->canvasW + clipped.x];
+	}
+
+	void Canvas::unlock() { this->locked = false; }
+
+	bool Canvas::update(const SDL_Rect& area, const uint32_t* src, int pitch) {
+		SDL_Rect clipped;
+		if (!this->touch(area, clipped)) return false;
+
+		//Skip the source pixels that were clipped off the top and left
+		src += (size_t)(clipped.y - area.y) * pitch + (clipped.x - area.x);
+		for (int row = 0; row < clipped.h; row++) {
+			std::memcpy(&this->pixels[(size_t)(clipped.y + row) * this->canvasW + clipped.x],
+				src + (size_t)row * pitch, (size_t)clipped.w * 4);
+		}
+		return true;
+	}
+
+	bool Canvas::fill(const SDL_Rect& area, uint32_t color) {
+		SDL_Rect clipped;
+		if (!this->touch(area, clipped)) return false;
+
+		for (int row = 0; row < clipped.h; row++) {
+			uint32_t* dst = &this->pixels[(size_t)(clipped.y + row) * this->canvasW + clipped.x];
+			for (int col = 0; col < clipped.w; col++) dst[col] = color;
+		}
+		return true;
+	}
+
+	void Canvas::clear(uint32_t color) {
+		this->fill({ 0, 0, this->canvasW, this->canvasH }, color);
+	}
+
+	bool Canvas::present() {
+		if (this->locked) {
+			this->error = "Canvas.present(): Canvas is still locked";
+			return false;
+		}
+		if (SDL_RectEmpty(&this->dirty)) return true;
+
+		//The back buffer missed the changes shown through the front one, so
+		// it takes those along with the new ones
+		int back = 1 - this->front;
+		if (this->buffers[back] == nullptr) {
+			this->error = "Canvas.present(): No streaming texture";
+			return false;
+		}
+		SDL_Rect area;
+		SDL_UnionRect(&this->dirty, &this->backStale, &area);
+		if (!this->upload(this->buffers[back], area)) {
+			this->error = "Canvas.present(): Texture could not be locked";
+			return false;
+		}
+
+		//Swap the buffers. The old front now lacks this frame's changes
+		this->front = back;
+		this->img = this->buffers[this->front];
+		this->backStale = this->dirty;
+		this->dirty = { 0, 0, 0, 0 };
+		this->changed();
+		return true;
+	}
+
+	int Canvas::getCanvasWidth() const { return this->canvasW; }
+	int Canvas::getCanvasHeight() const { return this->canvasH; }
+}
\ No newline at end of file
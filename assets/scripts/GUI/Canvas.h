@@ -0,0 +1,118 @@
+#ifndef CANVAS_H
+#define CANVAS_H
+
+#include <SDL.h>
+#include <iostream>
+#include <vector>
+#include <stdint.h>
+
+#include "./Displayable.h"
+
+//Define the GUI namespace
+namespace GUI {
+
+	/* A Displayable whose pixels are generated at runtime, for effects such
+	*   as move highlights or evaluation heatmaps that change every frame.
+	*
+	*  Producers draw into a CPU copy of the canvas through lock()/unlock(),
+	*   update() or fill(), which only mark the touched area as dirty.
+	*   present() then uploads the dirty area into one of two streaming
+	*   textures and swaps it to the front, so the texture being drawn this
+	*   frame is never the one being written. Only changed rows are uploaded.
+	*
+	*  Pixels are SDL_PIXELFORMAT_ARGB8888. The canvas is drawn through the
+	*   normal Displayable path, scaled to the Displayable's rect, so it can
+	*   be placed in a PegBar like any other asset. All calls must be made on
+	*   the render thread.
+	*/
+	class Canvas : public Displayable {
+	private:
+		SDL_Texture* buffers[2]; //The streaming textures, img is the front one
+		int front; //The index of the buffer being drawn
+
+		std::vector<uint32_t> pixels; //The CPU copy, one row after another
+		int canvasW, canvasH; //The size of the canvas in pixels
+
+		SDL_Rect dirty; //Area changed since the last present()
+		SDL_Rect backStale; //Area the back buffer missed when it was last
+		// swapped out
+		bool locked;
+
+		//Clips area to the canvas and adds it to the dirty area. Returns
+		// false IFF nothing of area lies on the canvas
+		bool touch(const SDL_Rect& area, SDL_Rect& clipped);
+
+		//Copies an area of the CPU copy into a streaming texture
+		bool upload(SDL_Texture* texture, const SDL_Rect& area);
+
+	public:
+		/*Creates a canvas of the given resolution, cleared to transparent. It
+		*  is displayed at (0, 0) at its own size until moved or resized.
+		*
+		* Preconditions:
+		* - renderer != nullptr
+		* - width > 0, height > 0
+		*/
+		Canvas(SDL_Renderer* renderer, int width, int height);
+
+		/*Creates a canvas of the given resolution, displayed in pos*/
+		Canvas(SDL_Renderer* renderer, int width, int height, SDL_Rect pos);
+
+		//Destroys both streaming textures
+		~Canvas();
+
+		/*Packs a color into the canvas' pixel format*/
+		static uint32_t color(Uint8 r, Uint8 g, Uint8 b, Uint8 a = 0xFF);
+
+		/*Gives direct access to an area of the canvas for drawing. The area
+		*  is marked dirty, so it is uploaded by the next present().
+		*
+		* Preconditions:
+		* - The canvas is not already locked
+		*
+		* Params:
+		* - area - the area to draw in
+		* - pitch - receives the length of a row in pixels
+		*
+		* Returns a pointer to the top-left pixel of the area IFF the area
+		*  lies entirely on the canvas, nullptr OW
+		*/
+		uint32_t* lock(const SDL_Rect& area, int* pitch);
+
+		//Ends drawing started with lock()
+		void unlock();
+
+		/*Copies pixels into an area of the canvas
+		*
+		* Params:
+		* - area - the area being replaced, clipped to the canvas
+		* - src - the source pixels, starting at the area's top-left corner
+		* - pitch - the length of a source row in pixels
+		*
+		* Returns true IFF the area overlaps the canvas, false OW
+		*/
+		bool update(const SDL_Rect& area, const uint32_t* src, int pitch);
+
+		/*Sets every pixel in an area of the canvas to one color
+		*
+		* Returns true IFF the area overlaps the canvas, false OW
+		*/
+		bool fill(const SDL_Rect& area, uint32_t color);
+
+		//Sets every pixel of the canvas to one color
+		void clear(uint32_t color);
+
+		/*Uploads the changes made since the last call and displays them
+		*
+		* Returns true IFF the canvas is unlocked and the upload succeeded,
+		*  false OW
+		*/
+		bool present();
+
+		//Accessors for the resolution of the canvas
+		int getCanvasWidth() const;
+		int getCanvasHeight() const;
+	};
+}
+
+#endif
\ No newline at end of file
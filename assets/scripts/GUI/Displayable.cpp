@@ -4,6 +4,8 @@
 
 #include "../utils.h"
 #include "./Displayable.h"
+#include "./Layering.h"
+#include "./AssetLoader.h"
 
 using std::cout;
 using std::endl;
@@ -32,8 +34,14 @@ namespace GUI {
 				"Displayable.render(): SDL_Renderer* argument is null";
 			return false;
 		}
-		//Ensure the texture exists
+		//Ensure the texture exists, drawing a placeholder if it is on its way
 		if (!this->hasTexture()) {
+			if (this->pendingLoads > 0) {
+				SDL_Rect currRect = this->getRect_Static();
+				SDL_SetRenderDrawColor(renderer, 0xD8, 0xCC, 0xE3, 0xFF);
+				SDL_RenderFillRect(renderer, &currRect);
+				return true;
+			}
 			this->error = "Displayable.render(): No texture found";
 			return false;
 		}
@@ -42,10 +50,24 @@ namespace GUI {
 			this->error = "Displayable.render(): Invalid width or height";
 		}
 
+		//Draw a copy already resized to the rect where possible, rather than
+		// have the renderer rescale the texture every frame
+		SDL_Texture* texture = this->img;
+		if (this->prescale && this->w > 0 && this->h > 0)
+			texture = this->scaledTexture(renderer);
+
+		//Apply this Displayable's opacity and tint. Textures can be shared,
+		// so the modulation is set on every draw rather than once. Opaque
+		// images only blend once they are made translucent
+		SDL_SetTextureAlphaMod(texture, this->opacity);
+		SDL_SetTextureColorMod(texture, this->tint.r, this->tint.g, this->tint.b);
+		if (this->opacity < 0xFF)
+			SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
 		//Access the static rect and use it to print the Displayable into
 		// the renderer
 		SDL_Rect currRect = this->getRect_Static();
-		SDL_RenderCopy(renderer, this->img, NULL, &currRect);
+		SDL_RenderCopy(renderer, texture, NULL, &currRect);
 
 		return true;
 	}
@@ -57,6 +79,7 @@ namespace GUI {
 		if (this->hasTexture()) this->dropTexture();
 		//Load the new texture and ensure that it's been opened successfully
 		this->img = util::LoadTexture(path, renderer);
+		this->changed();
 		if (!this->img) {
 			this->error = "Displayable.setTexture(): Texture failed to load";
 			return false;
@@ -69,16 +92,44 @@ namespace GUI {
 		if (this->hasTexture()) this->dropTexture();
 		//Assign the new texture
 		this->img = img;
+		this->changed();
 		return true;
 	}
 
+	void Displayable::loadTexture(const char* path) {
+		//Dispose of the current texture if one exists
+		if (this->hasTexture()) this->dropTexture();
+		//Ask the loader for the new one
+		this->pendingLoads++;
+		AssetLoader::instance().request(path, this, util::STR_ANONYMOUS);
+	}
+
+	void Displayable::receiveTexture(util::StrID tag, SDL_Texture* texture) {
+		this->pendingLoads--;
+		if (texture == nullptr) {
+			this->error = "Displayable.receiveTexture(): Texture failed to load";
+			this->changed();
+			return;
+		}
+		this->setTexture(texture);
+	}
+
+	bool Displayable::isLoading() const { return this->pendingLoads > 0; }
+
+	void Displayable::cancelLoads() {
+		AssetLoader::instance().cancel(this);
+		this->pendingLoads = 0;
+	}
+
 	bool Displayable::dropTexture() {
 		if (!this->hasTexture()) {
 			this->error = "Displayable.dropTexture(): No texture to destroy";
 			return false;
 		}
+		this->dropScaled(this->img);
 		if (this->destroyOnDrop) SDL_DestroyTexture(this->img);
 		this->img = nullptr;
+		this->changed();
 		return true;
 	}
 
@@ -91,77 +142,144 @@ namespace GUI {
 	int Displayable::getWidth() const { return this->w; }
 	int Displayable::getHeight() const { return this->h; }
 
-	void Displayable::setX(int x) { this->x = x; }
-	void Displayable::setY(int y) { this->y = y; }
-	void Displayable::setWidth(int w) { this->w = w; }
-	void Displayable::setHeight(int h) { this->h = h; }
+	void Displayable::setX(int x) { this->x = x; this->moved(); }
+	void Displayable::setY(int y) { this->y = y; this->moved(); }
+	void Displayable::setWidth(int w) { this->w = w; this->moved(); }
+	void Displayable::setHeight(int h) { this->h = h; this->moved(); }
 
 	void Displayable::setRect(SDL_Rect newRect) {
 		//Reset offset values
 		this->xoffset = 0;
 		this->yoffset = 0;
 		this->woffset = 0;
-		this->yoffset = 0;
+		this->hoffset = 0;
 		//Store rect information
 		this->x = newRect.x;
 		this->y = newRect.y;
 		this->w = newRect.w;
 		this->h = newRect.h;
+		this->moved();
 	}
 
-	void Displayable::setXOffset(int x) { this->xoffset = x; }
-	void Displayable::setYOffset(int y) { this->yoffset = y; }
-	void Displayable::setWOffset(int w) { this->woffset = w; }
-	void Displayable::setHOffset(int h) { this->hoffset = h; }
+	void Displayable::setXOffset(int x) { this->xoffset = x; this->moved(); }
+	void Displayable::setYOffset(int y) { this->yoffset = y; this->moved(); }
+	void Displayable::setWOffset(int w) { this->woffset = w; this->moved(); }
+	void Displayable::setHOffset(int h) { this->hoffset = h; this->moved(); }
+
+	void Displayable::setOpacity(Uint8 opacity) { this->opacity = opacity; this->changed(); }
+	Uint8 Displayable::getOpacity() const { return this->opacity; }
+
+	void Displayable::setTint(SDL_Color tint) { this->tint = tint; this->changed(); }
+	SDL_Color Displayable::getTint() const { return this->tint; }
+
+	void Displayable::setLayout(const Layout& layout) {
+		this->layout = layout;
+		this->hasLayout = true;
+		this->relayout(util::getScreenWidth(), util::getScreenHeight());
+	}
+
+	void Displayable::clearLayout() { this->hasLayout = false; }
+
+	void Displayable::relayout(int width, int height) {
+		if (this->hasLayout) this->setRect(this->layout.resolve(width, height));
+	}
+
+	void Displayable::setPrescale(bool prescale) {
+		this->prescale = prescale;
+		if (!prescale) this->dropScaled(nullptr);
+	}
+
+	void Displayable::resetScaled() { this->dropScaled(nullptr); }
 
 	std::string Displayable::getError() const { return this->error; }
 
+	DisplayableType Displayable::getType() const { return this->type; }
 
-	bool Button::collidepoint(int x, int y) const {
-		//If the sizes are negative, throw an error
-		//if (this->w <= 0 || this->h <= 0) return false;
+	bool Displayable::isInteractive() const { return this->type == DISP_BUTTON; }
+
+	void Displayable::setOwner(PegBar* owner, uint32_t slot) {
+		this->owner = owner;
+		this->ownerSlot = slot;
+	}
+
+	void Displayable::moved() {
+		if (this->owner != nullptr) this->owner->assetMoved(this->ownerSlot);
+	}
+
+	void Displayable::changed() {
+		if (this->owner != nullptr) this->owner->assetChanged(this->ownerSlot);
+	}
+
+	SDL_Texture* Displayable::scaledTexture(SDL_Renderer* renderer) {
+		//Copies made for another size are of no further use
+		if (this->w != this->scaledW || this->h != this->scaledH) {
+			this->dropScaled(nullptr);
+			this->scaledW = this->w;
+			this->scaledH = this->h;
+		}
+
+		map<SDL_Texture*, SDL_Texture*>::const_iterator i = this->scaled.find(this->img);
+		if (i != this->scaled.end())
+			return (i->second != nullptr) ? i->second : this->img;
+
+		//Make the copy the first time the texture is drawn at this size
+		int texW = 0, texH = 0;
+		SDL_Texture* copy = nullptr;
+		SDL_QueryTexture(this->img, NULL, NULL, &texW, &texH);
+		if (texW != this->w || texH != this->h)
+			copy = util::ScaleTexture(this->img, renderer, this->w, this->h);
+		this->scaled[this->img] = copy;
 
-		/*//Ensure it's within the button horizontalls
-		bool pastleft = x > this->x;
-		bool pastright = x < this->x + this->w;
-		//Ensure it's within the button vertically
-		bool pasttop = y > this->y;
-		bool pastbottom = y < this->y + this->h;
-		*/
+		return (copy != nullptr) ? copy : this->img;
+	}
 
-		SDL_Rect rect = this->getRect_Dynamic();
-		
-		if (rect.w <= 0 || rect.h <= 0) return false;
+	void Displayable::dropScaled(SDL_Texture* texture) {
+		for (auto i = this->scaled.begin(); i != this->scaled.end(); ) {
+			if (texture != nullptr && i->first != texture) {
+				++i;
+				continue;
+			}
+			if (i->second != nullptr) SDL_DestroyTexture(i->second);
+			i = this->scaled.erase(i);
+		}
+	}
 
-		bool left = x > rect.x;
-		bool right = x < rect.x + rect.w;
-		bool top = y > rect.y;
-		bool bottom = y < rect.y + rect.h;
 
-		//Make sure tha tall of these are true
-		return left && right && top && bottom;
+	bool Button::collidepoint(int x, int y) const {
+		return util::rectContains(this->getRect_Dynamic(), x, y);
 	}
 
-	bool Button::setPose(string name) {
+	bool Button::setPose(const string& name) {
+		return this->setPose(util::findInterned(name));
+	}
+
+	bool Button::setPose(util::StrID pose) {
 		//If the new and old textures are the same, exit immediately
-		if (name == this->getPose())
+		if (pose == this->currPose)
 			return true;
 
-		//If the texture does not exist in this->textures, set the error and exit
-		if (this->textures.count(name) == 0 || this->textures.at(name) == nullptr) {
+		//If the texture does not exist in this->textures, set the error and exit.
+		// A pose that is still loading is accepted and shows a placeholder
+		map<util::StrID, SDL_Texture*>::const_iterator i = this->textures.find(pose);
+		if (i == this->textures.end() || (i->second == nullptr && this->pendingLoads == 0)) {
 			this->error = "Button.setPose(): No texture found";
 			return false;
 		}
 
 		//Update the displayed texture to the specified texture and exit
-		this->img = this->textures[name];
+		this->img = i->second;
+		this->currPose = pose;
+		this->changed();
 		return true;
 	}
 
-	string Button::getPose() const { return this->currPose; }
+	string Button::getPose() const { return util::unintern(this->currPose); }
+
+	util::StrID Button::getPoseID() const { return this->currPose; }
 	
-	bool Button::givePose(string name, const char* path, SDL_Renderer* renderer) {
-		if (this->textures.count(name)) {
+	bool Button::givePose(const string& name, const char* path, SDL_Renderer* renderer) {
+		util::StrID pose = util::intern(name);
+		if (this->textures.count(pose)) {
 			this->error = "Button.givePose(): Texture already exists";
 			return false;
 		}
@@ -172,14 +290,47 @@ namespace GUI {
 			return false;
 		}
 
-		this->textures[name] = texture;
+		this->textures[pose] = texture;
 		return true;
 	}
 
-	string Button::getFlag() const { return this->flag; }
+	bool Button::queuePose(const string& name, const char* path) {
+		util::StrID pose = util::intern(name);
+		if (this->textures.count(pose)) {
+			this->error = "Button.queuePose(): Texture already exists";
+			return false;
+		}
+
+		//Reserve the pose now, the texture is filled in once it arrives
+		this->textures[pose] = nullptr;
+		this->pendingLoads++;
+		AssetLoader::instance().request(path, this, pose);
+		return true;
+	}
+
+	void Button::receiveTexture(util::StrID pose, SDL_Texture* texture) {
+		this->pendingLoads--;
+		if (texture == nullptr) {
+			this->error = "Button.receiveTexture(): Texture failed to load";
+			this->changed();
+			return;
+		}
+
+		this->textures[pose] = texture;
+		if (pose == this->currPose) {
+			this->img = texture;
+			this->changed();
+		}
+	}
+
+	string Button::getFlag() const { return util::unintern(this->flag); }
+
+	util::StrID Button::getFlagID() const { return this->flag; }
+
+	bool Button::setFlag(const string& flag) { return this->setFlag(util::intern(flag)); }
 
-	bool Button::setFlag(string flag) {
-		if (this->flag != util::ANONYMOUS) {
+	bool Button::setFlag(util::StrID flag) {
+		if (this->flag != util::STR_ANONYMOUS) {
 			this->error = "Button.setFlag(): Cannot override existing flag";
 			return false;
 		}
@@ -8,6 +8,8 @@
 #include <map>
 
 #include "../utils.h"
+#include "../intern.h"
+#include "./Layout.h"
 
 using std::cout;
 using std::endl;
@@ -18,9 +20,12 @@ using std::string;
 //Define the GUI namespace
 namespace GUI {
 
+	class PegBar;
+
 	enum DisplayableType {
 		DISP_BASIC,
-		DISP_BUTTON
+		DISP_BUTTON,
+		DISP_CANVAS
 	};
 
 	/* The base class for an object that can be displayed on screen. Contains
@@ -44,6 +49,43 @@ namespace GUI {
 		string error; //Stores any error present with the current displayable
 		DisplayableType type;
 
+		PegBar* owner = nullptr; //The PegBar holding this Displayable, if any
+		uint32_t ownerSlot = 0; //The slot this Displayable occupies in its owner
+
+		int pendingLoads = 0; //Textures requested from the AssetLoader but not
+		// yet received. A placeholder is drawn while img is missing
+
+		Layout layout; //Where the Displayable sits on screen, if hasLayout
+		bool hasLayout = false;
+
+		bool prescale = true; //Whether textures are resized ahead of drawing
+		map<SDL_Texture*, SDL_Texture*> scaled; //Copies of each texture drawn,
+		// resized to scaledW x scaledH. nullptr marks one drawn as it is
+		int scaledW = 0, scaledH = 0;
+
+		Uint8 opacity = 0xFF; //Alpha applied to the texture at draw time
+		SDL_Color tint = { 0xFF, 0xFF, 0xFF, 0xFF }; //Color the texture is
+		// multiplied by at draw time, white leaves it unchanged
+
+		//Withdraws any outstanding AssetLoader requests
+		void cancelLoads();
+
+		//Informs the owning PegBar that the dynamic rect has changed
+		void moved();
+
+		//Informs the owning PegBar that the Displayable looks different
+		void changed();
+
+		/*Finds the texture to draw for img: a copy resized to the current
+		*  size, made once and reused until the size changes. Falls back to
+		*  img itself IFF it already has the right size or cannot be resized.
+		*/
+		SDL_Texture* scaledTexture(SDL_Renderer* renderer);
+
+		//Destroys the resized copy of a texture, or of every texture IFF
+		// texture == nullptr
+		void dropScaled(SDL_Texture* texture);
+
 	public:
 		/*Default constructor, initializes all fields to null values*/
 		Displayable() {
@@ -176,7 +218,9 @@ namespace GUI {
 		}
 
 		//Destroys the texture if speficied to prevent memory leaks
-		~Displayable() {
+		virtual ~Displayable() {
+			if (this->pendingLoads > 0) this->cancelLoads();
+			this->dropScaled(nullptr);
 			if (this->hasTexture() && this->destroyOnDrop)
 				SDL_DestroyTexture(this->img);
 		}
@@ -209,7 +253,8 @@ namespace GUI {
 		* - renderer is the SDL_Renderer that gets printed onto the
 		*   game's window
 		*
-		* Returns true IFF img != nullptr && w > 0 && h > 0, false OW
+		* Returns true IFF (img != nullptr || a texture is still loading)
+		*  && w > 0 && h > 0, false OW
 		*/
 		bool render(SDL_Renderer* renderer);
 
@@ -259,6 +304,33 @@ namespace GUI {
 		*/
 		bool setTexture(SDL_Texture* img);
 
+		/*Requests a texture from the AssetLoader, which decodes it off the
+		*  render thread. A placeholder is rendered until the texture arrives.
+		*
+		* Preconditions:
+		* - path != null
+		*
+		* Postcondition:
+		* - Any current texture is dropped
+		*
+		* Params:
+		* - path is the path (relative to the game's root folder) that
+		*   the texture resides at.
+		*/
+		void loadTexture(const char* path);
+
+		/*Accepts a texture requested through the AssetLoader. Called by
+		*  AssetLoader::pump() on the render thread.
+		*
+		* Params:
+		* - tag is the tag the texture was requested with
+		* - texture is the uploaded texture, nullptr if loading failed
+		*/
+		virtual void receiveTexture(util::StrID tag, SDL_Texture* texture);
+
+		//Checks whether any requested textures have yet to arrive
+		bool isLoading() const;
+
 		/*Disposes of the texture currently stored in the Displayable. If the
 		*  displayable is set to destroy textures on disposal (as is default)
 		*  then the texture will be globally destroyed. Otherwise, it simply has
@@ -317,8 +389,73 @@ namespace GUI {
 		void setWOffset(int w);
 		void setHOffset(int h);
 
+		/*Positions the Displayable by a Layout rather than a fixed rect, and
+		*  applies it at the current screen size. The rect is recomputed by
+		*  relayout() whenever the window is resized, replacing any position
+		*  or size set directly in the meantime.
+		*/
+		void setLayout(const Layout& layout);
+
+		//Returns to positioning by a fixed rect, keeping the current one
+		void clearLayout();
+
+		/*Recomputes the rect from the Layout for a new screen size. Does
+		*  nothing IFF no Layout is set.
+		*
+		* Params:
+		* - width - the width of the screen in pixels
+		* - height - the height of the screen in pixels
+		*/
+		void relayout(int width, int height);
+
+		/*Toggles whether textures are resized once ahead of drawing (the
+		*  default) or stretched by the renderer on every draw. Turn it off for
+		*  textures whose contents change, such as render targets.
+		*/
+		void setPrescale(bool prescale);
+
+		/*Destroys the resized copies of the textures so they are made afresh
+		*  on the next draw. The copies are render targets, so their contents
+		*  are lost whenever the renderer resets its targets.
+		*/
+		void resetScaled();
+
+		/*Sets how opaque the Displayable is drawn. This is applied with
+		*  SDL_SetTextureAlphaMod at draw time, so the texture itself is left
+		*  untouched and can be shared by Displayables of any opacity.
+		*
+		* Params:
+		* - opacity - 0 for fully transparent through 255 for fully opaque
+		*/
+		void setOpacity(Uint8 opacity);
+		Uint8 getOpacity() const;
+
+		/*Sets the color the texture is multiplied by when drawn, applied with
+		*  SDL_SetTextureColorMod. The alpha of the color is ignored.
+		*
+		* Params:
+		* - tint - the color to multiply by, white for no tint
+		*/
+		void setTint(SDL_Color tint);
+		SDL_Color getTint() const;
+
 		//Accesses the most recent error that has occurred in this Displayable
 		string getError() const;
+
+		//Accesses the kind of Displayable this is
+		DisplayableType getType() const;
+
+		/*Checks whether the Displayable responds to the mouse. Only interactive
+		*  Displayables are returned by PegBar::hitTest()
+		*
+		* Returns true IFF this Displayable is a Button, false OW
+		*/
+		bool isInteractive() const;
+
+		/*Records the PegBar that holds this Displayable so it can be told
+		*  about changes. Called by PegBar; owner == nullptr detaches it.
+		*/
+		void setOwner(PegBar* owner, uint32_t slot);
 	};
 
 	/* The class for a clickable rectangular button. It contains all the data
@@ -327,23 +464,23 @@ namespace GUI {
 	*/
 	class Button : public Displayable {
 	private:
-		string flag;
-		map<string, SDL_Texture*> textures;
-		string currPose;
+		util::StrID flag; //The interned flag/identifier of the button
+		map<util::StrID, SDL_Texture*> textures; //Textures keyed by interned pose name
+		util::StrID currPose; //The interned name of the displayed pose
 
 	public:
 		Button() : Displayable() {
 			this->type = DISP_BUTTON;
-			this->flag = util::ANONYMOUS;
+			this->flag = util::STR_ANONYMOUS;
 
-			this->currPose = util::ANONYMOUS;
+			this->currPose = util::STR_ANONYMOUS;
 		}
 
 		Button(string flag) : Displayable() {
 			this->type = DISP_BUTTON;
-			this->flag = flag;
+			this->flag = util::intern(flag);
 
-			this->currPose = util::ANONYMOUS;
+			this->currPose = util::STR_ANONYMOUS;
 		}
 
 		Button(SDL_Renderer* renderer, map<string, const char*> paths) {
@@ -358,8 +495,9 @@ namespace GUI {
 			this->hoffset = 0;
 
 			for (auto i = paths.begin(); i != paths.end(); ++i) {
-				this->textures[i->first] = util::LoadTexture(i->second, renderer);
-				if (!this->textures[i->first])
+				util::StrID pose = util::intern(i->first);
+				this->textures[pose] = util::LoadTexture(i->second, renderer);
+				if (!this->textures[pose])
 					this->error = "Button(): Texture failed to load";
 			}
 			if (this->textures.empty())
@@ -369,11 +507,15 @@ namespace GUI {
 			this->error = "";
 
 			this->type = DISP_BUTTON;
-			this->flag = util::ANONYMOUS;
+			this->flag = util::STR_ANONYMOUS;
 
-			map<string, SDL_Texture*>::iterator i;
-			this->currPose = i->first;
-			this->img = i->second;
+			//Display the first pose, if any loaded
+			this->currPose = util::STR_ANONYMOUS;
+			this->img = nullptr;
+			if (!this->textures.empty()) {
+				this->currPose = this->textures.begin()->first;
+				this->img = this->textures.begin()->second;
+			}
 		}
 
 		Button(SDL_Renderer* renderer, map<string, const char*> paths, string flag) {
@@ -388,8 +530,9 @@ namespace GUI {
 			this->hoffset = 0;
 
 			for (auto i = paths.begin(); i != paths.end(); ++i) {
-				this->textures[i->first] = util::LoadTexture(i->second, renderer);
-				if (!this->textures[i->first])
+				util::StrID pose = util::intern(i->first);
+				this->textures[pose] = util::LoadTexture(i->second, renderer);
+				if (!this->textures[pose])
 					this->error = "Button(): Texture failed to load";
 			}
 			if (this->textures.empty())
@@ -399,43 +542,47 @@ namespace GUI {
 			this->error = "";
 
 			this->type = DISP_BUTTON;
-			this->flag = flag;
+			this->flag = util::intern(flag);
 
-			map<string, SDL_Texture*>::iterator i;
-			this->currPose = i->first;
-			this->img = i->second;
+			//Display the first pose, if any loaded
+			this->currPose = util::STR_ANONYMOUS;
+			this->img = nullptr;
+			if (!this->textures.empty()) {
+				this->currPose = this->textures.begin()->first;
+				this->img = this->textures.begin()->second;
+			}
 		}
 
 		Button(SDL_Rect rect) :
 			Displayable(rect) {
 			this->type = DISP_BUTTON;
-			this->flag = util::ANONYMOUS;
+			this->flag = util::STR_ANONYMOUS;
 
-			this->currPose = util::ANONYMOUS;
+			this->currPose = util::STR_ANONYMOUS;
 		}
 
 		Button(SDL_Rect rect, string flag) :
 			Displayable(rect) {
 			this->type = DISP_BUTTON;
-			this->flag = flag;
+			this->flag = util::intern(flag);
 
-			this->currPose = util::ANONYMOUS;
+			this->currPose = util::STR_ANONYMOUS;
 		}
 
 		Button(int w, int h) :
 			Displayable(w, h) {
 			this->type = DISP_BUTTON;
-			this->flag = util::ANONYMOUS;
+			this->flag = util::STR_ANONYMOUS;
 
-			this->currPose = util::ANONYMOUS;
+			this->currPose = util::STR_ANONYMOUS;
 		}
 
 		Button(int w, int h, string flag) :
 			Displayable(w, h) {
 			this->type = DISP_BUTTON;
-			this->flag = flag;
+			this->flag = util::intern(flag);
 
-			this->currPose = util::ANONYMOUS;
+			this->currPose = util::STR_ANONYMOUS;
 		}
 
 		Button(SDL_Renderer* renderer, map<string, const char*> paths, int w, int h) {
@@ -450,8 +597,9 @@ namespace GUI {
 			this->hoffset = 0;
 
 			for (auto i = paths.begin(); i != paths.end(); ++i) {
-				this->textures[i->first] = util::LoadTexture(i->second, renderer);
-				if (!this->textures[i->first])
+				util::StrID pose = util::intern(i->first);
+				this->textures[pose] = util::LoadTexture(i->second, renderer);
+				if (!this->textures[pose])
 					this->error = "Button(): Texture failed to load";
 			}
 			if (this->textures.empty())
@@ -461,11 +609,15 @@ namespace GUI {
 			this->error = "";
 
 			this->type = DISP_BUTTON;
-			this->flag = util::ANONYMOUS;
+			this->flag = util::STR_ANONYMOUS;
 
-			map<string, SDL_Texture*>::iterator i;
-			this->currPose = i->first;
-			this->img = i->second;
+			//Display the first pose, if any loaded
+			this->currPose = util::STR_ANONYMOUS;
+			this->img = nullptr;
+			if (!this->textures.empty()) {
+				this->currPose = this->textures.begin()->first;
+				this->img = this->textures.begin()->second;
+			}
 		}
 
 		Button(SDL_Renderer* renderer, map<string,
@@ -481,8 +633,9 @@ namespace GUI {
 			this->hoffset = 0;
 
 			for (auto i = paths.begin(); i != paths.end(); ++i) {
-				this->textures[i->first] = util::LoadTexture(i->second, renderer);
-				if (!this->textures[i->first])
+				util::StrID pose = util::intern(i->first);
+				this->textures[pose] = util::LoadTexture(i->second, renderer);
+				if (!this->textures[pose])
 					this->error = "Button(): Texture failed to load";
 			}
 			if (this->textures.empty())
@@ -492,11 +645,15 @@ namespace GUI {
 			this->error = "";
 
 			this->type = DISP_BUTTON;
-			this->flag = flag;
+			this->flag = util::intern(flag);
 
-			map<string, SDL_Texture*>::iterator i;
-			this->currPose = i->first;
-			this->img = i->second;
+			//Display the first pose, if any loaded
+			this->currPose = util::STR_ANONYMOUS;
+			this->img = nullptr;
+			if (!this->textures.empty()) {
+				this->currPose = this->textures.begin()->first;
+				this->img = this->textures.begin()->second;
+			}
 		}
 
 		Button(SDL_Renderer* renderer, map<string, const char*> paths, SDL_Rect pos) {
@@ -511,8 +668,9 @@ namespace GUI {
 			this->hoffset = 0;
 
 			for (auto i = paths.begin(); i != paths.end(); ++i) {
-				this->textures[i->first] = util::LoadTexture(i->second, renderer);
-				if (!this->textures[i->first])
+				util::StrID pose = util::intern(i->first);
+				this->textures[pose] = util::LoadTexture(i->second, renderer);
+				if (!this->textures[pose])
 					this->error = "Button(): Texture failed to load";
 			}
 			if (this->textures.empty())
@@ -522,11 +680,15 @@ namespace GUI {
 			this->error = "";
 
 			this->type = DISP_BUTTON;
-			this->flag = util::ANONYMOUS;
+			this->flag = util::STR_ANONYMOUS;
 
-			map<string, SDL_Texture*>::iterator i;
-			this->currPose = i->first;
-			this->img = i->second;
+			//Display the first pose, if any loaded
+			this->currPose = util::STR_ANONYMOUS;
+			this->img = nullptr;
+			if (!this->textures.empty()) {
+				this->currPose = this->textures.begin()->first;
+				this->img = this->textures.begin()->second;
+			}
 		}
 
 		Button(SDL_Renderer* renderer, map<string, const char*> paths,
@@ -542,8 +704,9 @@ namespace GUI {
 			this->hoffset = 0;
 
 			for (auto i = paths.begin(); i != paths.end(); ++i) {
-				this->textures[i->first] = util::LoadTexture(i->second, renderer);
-				if (!this->textures[i->first])
+				util::StrID pose = util::intern(i->first);
+				this->textures[pose] = util::LoadTexture(i->second, renderer);
+				if (!this->textures[pose])
 					this->error = "Button(): Texture failed to load";
 			}
 			if (this->textures.empty())
@@ -553,11 +716,15 @@ namespace GUI {
 			this->error = "";
 
 			this->type = DISP_BUTTON;
-			this->flag = flag;
+			this->flag = util::intern(flag);
 
-			map<string, SDL_Texture*>::iterator i;
-			this->currPose = i->first;
-			this->img = i->second;
+			//Display the first pose, if any loaded
+			this->currPose = util::STR_ANONYMOUS;
+			this->img = nullptr;
+			if (!this->textures.empty()) {
+				this->currPose = this->textures.begin()->first;
+				this->img = this->textures.begin()->second;
+			}
 		}
 
 		~Button() {
@@ -565,6 +732,8 @@ namespace GUI {
 				if (i->second != nullptr && this->destroyOnDrop)
 					SDL_DestroyTexture(i->second);
 			}
+			//img is one of the poses, so keep ~Displayable from destroying it twice
+			this->img = nullptr;
 		}
 
 		
@@ -593,7 +762,21 @@ namespace GUI {
 		* 
 		* Returns true IFF the texture exists and was successfully assigned, false OW
 		*/
-		bool setPose(string name);
+		bool setPose(const string& name);
+
+		/*Changes the Button's displayed texture by interned pose name. This is
+		*  the overload to use every frame, as it involves no string handling.
+		*
+		* Preconditions:
+		* - 'pose' must be associated with a SDL_Texture loaded in this->textures,
+		*   or one still being loaded through queuePose()
+		*
+		* Params:
+		* - pose - the interned name of the pose (see util::intern)
+		*
+		* Returns true IFF the texture exists and was successfully assigned, false OW
+		*/
+		bool setPose(util::StrID pose);
 
 		/*Provides the string-name associated with the texture currently displayed
 		* 
@@ -601,6 +784,9 @@ namespace GUI {
 		*/
 		string getPose() const;
 
+		//Provides the interned name of the texture currently displayed
+		util::StrID getPoseID() const;
+
 		/*Inserts an SDL_Texture into the textures list internal to the button
 		* 
 		* Preconditions:
@@ -614,7 +800,27 @@ namespace GUI {
 		* Returns true IFF 'name' does not already reference an existing texture AND 
 		*  the image at 'path' was successfully opened and stored
 		*/
-		bool givePose(string name, const char* path, SDL_Renderer* renderer);
+		bool givePose(const string& name, const char* path, SDL_Renderer* renderer);
+
+		/*Registers a pose whose texture is decoded in the background by the
+		*  AssetLoader. The pose can be selected with setPose() straight away;
+		*  a placeholder is rendered until its texture arrives.
+		*
+		* Preconditions:
+		* - 'name' cannot already be associated with a pose in the button
+		*
+		* Params:
+		* - name - the name that will be used to access the texture later
+		* - path - the location of the image being loaded as a texture
+		*
+		* Returns true IFF 'name' did not already reference a pose, false OW
+		*/
+		bool queuePose(const string& name, const char* path);
+
+		/*Stores a pose texture delivered by the AssetLoader, displaying it
+		*  immediately if it belongs to the current pose.
+		*/
+		void receiveTexture(util::StrID pose, SDL_Texture* texture);
 
 		/*Provides the flag of the button for when it is pressed
 		* 
@@ -622,17 +828,21 @@ namespace GUI {
 		*/
 		string getFlag() const;
 
+		//Provides the interned flag of the button
+		util::StrID getFlagID() const;
+
 		/*Assigns the button's flag
 		* 
 		* Precondition:
-		* this->flag == util::ANONYMOUS
+		* this->flag == util::STR_ANONYMOUS
 		* 
 		* Params:
 		* - flag - the flag/identifier being provided to the button
 		* 
 		* Returns true IFF the flag was set, false OW
 		*/
-		bool setFlag(string flag);
+		bool setFlag(const string& flag);
+		bool setFlag(util::StrID flag);
 	};
 }
 
@@ -0,0 +1,96 @@
+#include <SDL.h>
+#include <iostream>
+#include <vector>
+#include <stdint.h>
+
+#include "./HitGrid.h"
+
+namespace GUI {
+	//Private
+	bool HitGrid::cellRange(SDL_Rect rect, int& c0, int& r0, int& c1, int& r1) const {
+		//Ignore empty rects and those lying entirely off the grid
+		if (rect.w <= 0 || rect.h <= 0) return false;
+		if (rect.x + rect.w <= 0 || rect.y + rect.h <= 0) return false;
+		if (rect.x >= this->cols * this->cellSize) return false;
+		if (rect.y >= this->rows * this->cellSize) return false;
+
+		//Convert the corners into cell coordinates, clamped to the grid
+		c0 = (rect.x < 0) ? 0 : rect.x / this->cellSize;
+		r0 = (rect.y < 0) ? 0 : rect.y / this->cellSize;
+		c1 = (rect.x + rect.w - 1) / this->cellSize;
+		r1 = (rect.y + rect.h - 1) / this->cellSize;
+		if (c1 >= this->cols) c1 = this->cols - 1;
+		if (r1 >= this->rows) r1 = this->rows - 1;
+		return true;
+	}
+
+	//Public
+	void HitGrid::resize(int width, int height, int cellSize) {
+		this->cellSize = cellSize;
+		this->cols = (width + cellSize - 1) / cellSize;
+		this->rows = (height + cellSize - 1) / cellSize;
+
+		//Empty the cells, then place every entry again at the new size
+		this->cells.assign(this->cols * this->rows, std::vector<uint32_t>());
+		for (uint32_t id = 0; id < this->placed.size(); id++) {
+			if (!this->placed[id]) continue;
+			this->placed[id] = false;
+			this->insert(id, this->bounds[id]);
+		}
+	}
+
+	void HitGrid::insert(uint32_t id, SDL_Rect rect) {
+		//Clear out any previous placement of the entry
+		this->remove(id);
+
+		if (id >= this->placed.size()) {
+			this->placed.resize(id + 1, false);
+			this->bounds.resize(id + 1);
+		}
+		this->placed[id] = true;
+		this->bounds[id] = rect;
+
+		//List the entry in each cell the rect overlaps
+		int c0, r0, c1, r1;
+		if (!this->cellRange(rect, c0, r0, c1, r1)) return;
+		for (int r = r0; r <= r1; r++)
+			for (int c = c0; c <= c1; c++)
+				this->cells[r * this->cols + c].push_back(id);
+	}
+
+	bool HitGrid::remove(uint32_t id) {
+		if (!this->contains(id)) return false;
+		this->placed[id] = false;
+
+		//Swap the entry out of each cell it was listed in
+		int c0, r0, c1, r1;
+		if (!this->cellRange(this->bounds[id], c0, r0, c1, r1)) return true;
+		for (int r = r0; r <= r1; r++) {
+			for (int c = c0; c <= c1; c++) {
+				std::vector<uint32_t>& cell = this->cells[r * this->cols + c];
+				for (int x = 0; x < cell.size(); x++) {
+					if (cell[x] != id) continue;
+					cell[x] = cell.back();
+					cell.pop_back();
+					break;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool HitGrid::contains(uint32_t id) const {
+		return id < this->placed.size() && this->placed[id];
+	}
+
+	const std::vector<uint32_t>& HitGrid::query(int x, int y) const {
+		static const std::vector<uint32_t> none;
+
+		if (x < 0 || y < 0) return none;
+		int c = x / this->cellSize;
+		int r = y / this->cellSize;
+		if (c >= this->cols || r >= this->rows) return none;
+
+		return this->cells[r * this->cols + c];
+	}
+}
\ No newline at end of file
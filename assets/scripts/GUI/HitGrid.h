@@ -0,0 +1,79 @@
+#ifndef HITGRID_H
+#define HITGRID_H
+
+#include <SDL.h>
+#include <iostream>
+#include <vector>
+#include <stdint.h>
+
+namespace GUI {
+	/* A uniform grid over the screen used to find which assets might lie
+	*   under a point. Each entry is identified by an integer ID (a PegBar
+	*   slot) and is listed in every cell its rect overlaps, so a query only
+	*   has to look at the handful of entries sharing the point's cell. The
+	*   default cell size matches one square of an 8x8 board filling the
+	*   screen's height.
+	*/
+	class HitGrid {
+	private:
+		int cellSize; //The width and height of each cell in pixels
+		int cols, rows; //The number of cells across and down
+
+		//The IDs listed in each cell, indexed by row * cols + col
+		std::vector<std::vector<uint32_t>> cells;
+		//The rect each ID was last placed with, indexed by ID
+		std::vector<SDL_Rect> bounds;
+		//Whether each ID is currently placed in the grid, indexed by ID
+		std::vector<bool> placed;
+
+		/*Finds the range of cells a rect overlaps, clamped to the grid
+		*
+		* Returns true IFF the rect overlaps at least one cell, false OW
+		*/
+		bool cellRange(SDL_Rect rect, int& c0, int& r0, int& c1, int& r1) const;
+
+	public:
+		HitGrid(int width, int height, int cellSize) {
+			this->cellSize = 1;
+			this->cols = 0;
+			this->rows = 0;
+			this->resize(width, height, cellSize);
+		}
+
+		/*Changes the area covered by the grid, keeping every placed entry
+		*
+		* Preconditions:
+		* - width > 0, height > 0, cellSize > 0
+		*/
+		void resize(int width, int height, int cellSize);
+
+		/*Places an entry in every cell its rect overlaps. If the entry is
+		*  already placed, it is moved instead.
+		*
+		* Params:
+		* - id - the identifier of the entry
+		* - rect - the area the entry covers
+		*/
+		void insert(uint32_t id, SDL_Rect rect);
+
+		/*Removes an entry from the grid
+		*
+		* Returns true IFF the entry was placed and has been removed, false OW
+		*/
+		bool remove(uint32_t id);
+
+		/*Checks whether an entry is currently placed in the grid*/
+		bool contains(uint32_t id) const;
+
+		/*Lists the entries whose cells include a point. The entries are only
+		*  candidates: the caller still needs to test the point against each
+		*  rect.
+		*
+		* Returns the entries in the cell containing (x, y), or an empty list
+		*  IFF the point is off the grid
+		*/
+		const std::vector<uint32_t>& query(int x, int y) const;
+	};
+}
+
+#endif
\ No newline at end of file
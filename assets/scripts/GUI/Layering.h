@@ -3,11 +3,13 @@
 
 #include <SDL.h>
 #include <iostream>
-#include <map>
 #include <vector>
 #include <stdint.h>
 
+#include "../intern.h"
 #include "./Displayable.h"
+#include "./AssetIndex.h"
+#include "./HitGrid.h"
 
 using std::string;
 
@@ -23,11 +25,43 @@ namespace GUI {
 	*/
 	class PegBar {
 	private:
-		//This is a vector containing string-Displayable pairs that makes
-		// the main data structure of the PegBar class
-		std::vector<std::map<std::string, GUI::Displayable*>> layers;
-		//This is a vector containing the keys of each layer
-		std::vector<std::vector<std::string>> layerKeys;
+		//A single layer. The Displayables are stored densely so rendering
+		// walks them directly, with the owning asset slot of each kept in a
+		// parallel vector
+		struct Layer {
+			std::vector<GUI::Displayable*> assets;
+			std::vector<uint32_t> slots;
+
+			//Static layers are drawn once into cache and blitted from there
+			bool isStatic = false;
+			SDL_Texture* cache = nullptr;
+			bool stale = true; //Whether cache needs redrawing
+		};
+
+		//An entry in the asset table that handles point into
+		struct AssetSlot {
+			GUI::Displayable* disp; //nullptr while the slot is free
+			util::StrID key; //The key the asset was inserted under
+			uint32_t generation; //Bumped each time the slot is freed
+			uint16_t layer; //The storage index of the layer holding the asset
+			uint32_t pos; //The asset's position within that layer
+		};
+
+		//This is a vector containing the storage for each layer. Storage is
+		// never reordered, only the order vector below is
+		std::vector<Layer> layers;
+		//This maps each layer index (render order) onto its storage index
+		std::vector<uint16_t> order;
+		//This maps each storage index back onto its layer index
+		std::vector<uint16_t> rank;
+		//This is the table of asset slots, indexed by AssetHandle::index
+		std::vector<AssetSlot> slots;
+		//This holds the indexes of the free entries in slots
+		std::vector<uint32_t> freeSlots;
+		//This maps each interned key onto the handle of its Displayable
+		GUI::AssetIndex index;
+		//This locates the interactive Displayables on screen by slot
+		GUI::HitGrid grid;
 		//This stores the last error flagged in the PegBar
 		std::string error;
 
@@ -46,19 +80,49 @@ namespace GUI {
 		*/
 		uint16_t countLayers() const;
 
+		//Rebuilds this->rank from this->order
+		void rebuildRanks();
+
+		//Destroys the cached texture of a layer, if it has one
+		static void dropCache(Layer& layer);
+
+		/*Draws a layer's Displayables onto the current render target, adding
+		*  the number drawn to draws
+		*
+		* Returns true IFF every Displayable rendered, false OW
+		*/
+		bool renderAssets(SDL_Renderer* renderer, const Layer& layer, uint32_t& draws);
+
+		/*Draws a static layer into its cache if it is stale, creating the
+		*  cache on first use. failed is set if a Displayable fails to render,
+		*  and the number drawn is added to draws.
+		*
+		* Returns true IFF the cache is up to date and can be blitted, false OW
+		*/
+		bool refreshCache(SDL_Renderer* renderer, Layer& layer, bool& failed, uint32_t& draws);
+
+		/*Removes the asset in a slot from its layer and frees the slot, bumping
+		*  its generation so outstanding handles become stale. The Displayable
+		*  is destroyed IFF wipeAsset == true.
+		*/
+		void releaseSlot(uint32_t slot, bool wipeAsset);
+
 	public:
 		/* Default constructor for the PegBar class. Initializes the
 		*   layer container with a Layer #0, and empties the error
 		*/
-		PegBar() {
+		PegBar() : grid(util::getScreenWidth(), util::getScreenHeight(),
+			util::getScreenHeight() / 8) {
 			this->makeLayer(0);
 			this->error = "";
 		};
 		/* Destroys all Displayables within the structure */
 		~PegBar() {
-			for (int x = 0; x < this->layers.size(); x++)
-				for (int y = 0; y < this->layerKeys[x].size(); y++)
-					delete this->layers[x][this->layerKeys[x][y]];
+			for (int x = 0; x < this->layers.size(); x++) {
+				for (int y = 0; y < this->layers[x].assets.size(); y++)
+					delete this->layers[x].assets[y];
+				dropCache(this->layers[x]);
+			}
 		};
 
 		/* Creates a new layer at the provided index. If the layer does not exist,
@@ -69,9 +133,9 @@ namespace GUI {
 		*   index.
 		*
 		* Postconditions:
-		* - this->layers.size() = #this->layers.size() + 1
-		* - this->layerKeys.size() = #this->layerKeys.size() + 1
-		* - All layers indexed > i are shifted up 1 IFF i <= #this->layers.size()
+		* - this->countLayers() = #this->countLayers() + 1
+		* - All layers indexed >= i are shifted up 1 IFF i < #this->countLayers()
+		* - No Displayables are moved, and all handles remain valid
 		*
 		* Param:
 		* - i - the position of the layer being added
@@ -87,11 +151,11 @@ namespace GUI {
 		*  shifted downward. If specified, all assets within the layer are destroyed.
 		*
 		* Preconditions:
-		* - this->layers.size() > 0
+		* - this->countLayers() > 0
 		*
 		* Postconditions:
-		* - this->layers.size() = #this->layers.size() - 1
-		* - this->layerKeys.size() = #this->layerKeys.size() - 1
+		* - this->countLayers() = #this->countLayers() - 1
+		* - Handles to the Displayables on the layer are no longer valid
 		*
 		* Param:
 		* - i - the index of the layer that is being destroyed
@@ -102,6 +166,55 @@ namespace GUI {
 		*/
 		bool dropLayer(uint16_t i, bool wipeAssets);
 
+		/*Marks a layer as static or dynamic. A static layer is rendered once
+		*  into an off-screen texture the size of the screen, and each frame
+		*  blits that single texture instead of drawing its Displayables. The
+		*  cache is redrawn automatically whenever a Displayable on the layer
+		*  is added, removed or mutated. If the renderer cannot render to
+		*  textures, the layer is drawn directly as usual.
+		*
+		* Params:
+		* - i - the index of the layer
+		* - isStatic - whether the layer is cached
+		*
+		* Returns true IFF the layer exists, false OW
+		*/
+		bool setLayerStatic(uint16_t i, bool isStatic);
+
+		//Checks whether a layer exists and is marked static
+		bool isLayerStatic(uint16_t i) const;
+
+		/*Forces a static layer's cache to be redrawn on the next render(), for
+		*  changes the PegBar cannot see (such as drawing into a texture that a
+		*  Displayable on the layer shares)
+		*
+		* Returns true IFF the layer exists, false OW
+		*/
+		bool invalidateLayer(uint16_t i);
+
+		/*Recovers from the renderer losing the contents of its render
+		*  targets (SDL_RENDER_TARGETS_RESET). Every static layer is redrawn
+		*  on the next render(), and resized copies of textures are remade.
+		*
+		* Params:
+		* - recreate - whether the caches are destroyed and created afresh,
+		*   as when the device itself was lost (SDL_RENDER_DEVICE_RESET)
+		*/
+		void resetTargets(bool recreate);
+
+		/*Adapts the structure to a new screen size. Every Displayable with a
+		*  Layout is repositioned, the hit-testing grid is rebuilt to cover the
+		*  screen, and static layers are redrawn at the new size.
+		*
+		* Preconditions:
+		* - width > 0, height > 0
+		*
+		* Params:
+		* - width - the new width of the screen in pixels
+		* - height - the new height of the screen in pixels
+		*/
+		void resize(int width, int height);
+
 		/*Inserts a Displayable into the specified layer, associating it with the
 		*  provided Key.
 		*
@@ -112,7 +225,8 @@ namespace GUI {
 		* - i must index a layer already existant in the structure
 		*
 		* Postcondition:
-		* - Fill this in later
+		* - The Displayable is rendered last among the assets of layer i
+		* - getHandle(key) returns a valid handle to the Displayable
 		*
 		* Params:
 		* - key - the string value used to identify the Displayable in the structure
@@ -142,13 +256,16 @@ namespace GUI {
 		* Returns true IFF the asset existed and was removed successfully, false OW
 		*/
 		bool removeAsset(std::string key, bool wipeAsset);
+		bool removeAsset(util::StrID key, bool wipeAsset);
+		bool removeAsset(GUI::AssetHandle handle, bool wipeAsset);
 
 		/*Renders all the displayables in the structure onto the provided renderer
 		*  so they can be printed to the game surface. Lower layer numbers are added
 		*  first, placing them lower on the game screen than higher numbered layers.
 		*  If the rendering fails for one of the Displayables in the structure, all
 		*  successful ones will still go through. This class will then inherit the
-		*  error message of the most recently failed Displayable.
+		*  error message of the most recently failed Displayable. The time and
+		*  draw calls of each layer are recorded with the Profiler.
 		*
 		* Precondition:
 		* - renderer != nullptr
@@ -174,6 +291,39 @@ namespace GUI {
 		*/
 		GUI::Displayable* getAssetByKey(std::string key);
 
+		/*Retrieves a Displayable by its interned key. This is a single hash
+		*  lookup and performs no allocation, making it suitable for per-frame use.
+		*
+		* Params:
+		* - key - the interned key associated with the Displayable (see util::intern)
+		*
+		* Returns a pointer to the Displayable associated with the key IFF it exists
+		*  in the structure, nullptr OW
+		*/
+		GUI::Displayable* getAssetByKey(util::StrID key);
+
+		/*Retrieves the handle of the Displayable associated with a key. Handles
+		*  are the cheapest way to reach an asset repeatedly, and unlike raw
+		*  pointers they can be checked for staleness.
+		*
+		* Returns the handle IFF the key exists in the structure, ASSET_NULL OW
+		*/
+		GUI::AssetHandle getHandle(std::string key) const;
+		GUI::AssetHandle getHandle(util::StrID key) const;
+
+		/*Checks whether a handle still refers to an asset in the structure
+		*
+		* Returns true IFF the handle's slot is occupied and its generation
+		*  matches, false OW
+		*/
+		bool isValid(GUI::AssetHandle handle) const;
+
+		/*Retrieves a Displayable through its handle
+		*
+		* Returns a pointer to the Displayable IFF the handle is valid, nullptr OW
+		*/
+		GUI::Displayable* getAsset(GUI::AssetHandle handle);
+
 		/*Retrieves the layer that the Displayable associated with key is found on.
 		*
 		* Params:
@@ -183,12 +333,55 @@ namespace GUI {
 		*  exists in the structure, -1 OW
 		*/
 		int32_t getLayerByKey(std::string key) const;
+		int32_t getLayerByKey(util::StrID key) const;
+		int32_t getLayerByHandle(GUI::AssetHandle handle) const;
+
+		/*Finds the topmost interactive Displayable under a point. Higher layers
+		*  are above lower ones, and within a layer later insertions are above
+		*  earlier ones, matching the order of render(). Only the assets sharing
+		*  the point's grid cell are examined, so the cost does not grow with
+		*  the number of assets in the structure.
+		*
+		* Params:
+		* - x - the x coordinate of the point
+		* - y - the y coordinate of the point
+		*
+		* Returns the handle of the topmost interactive Displayable whose dynamic
+		*  rect contains the point IFF there is one, ASSET_NULL OW
+		*/
+		GUI::AssetHandle hitTest(int x, int y) const;
+
+		/*Updates the hit-testing grid after a Displayable's dynamic rect has
+		*  changed, and invalidates its layer's cache. Displayables call this
+		*  themselves when they are mutated.
+		*
+		* Params:
+		* - slot - the slot of the Displayable that moved
+		*/
+		void assetMoved(uint32_t slot);
+
+		/*Invalidates the cache of the layer holding a Displayable whose
+		*  appearance has changed. Displayables call this themselves.
+		*
+		* Params:
+		* - slot - the slot of the Displayable that changed
+		*/
+		void assetChanged(uint32_t slot);
 
 		//Accesses the most recent error that has occurred in this Displayable
 		std::string getError() const;
 
 		//Accesses a list of all the keys in the Layer structure
 		std::vector<std::string> getKeys() const;
+
+		/*Fills a list with the interned keys of every Displayable, in render
+		*  order. The list is cleared first, so a caller that keeps one around
+		*  performs no allocation once it has grown to size.
+		*
+		* Params:
+		* - out - the list being filled
+		*/
+		void getKeyIDs(std::vector<util::StrID>& out) const;
 	};
 }
 
@@ -0,0 +1,52 @@
+#include <SDL.h>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#include "../utils.h"
+#include "./Layout.h"
+
+//Define the GUI namespace
+namespace GUI {
+	Layout Layout::fixed(float anchorX, float anchorY,
+		float pivotX, float pivotY, int width, int height) {
+		return {
+			anchorX, anchorY,
+			pivotX, pivotY,
+			0, 0,
+			(float)width, (float)height,
+			false, false
+		};
+	}
+
+	Layout Layout::relative(float anchorX, float anchorY,
+		float pivotX, float pivotY, float width, float height) {
+		return {
+			anchorX, anchorY,
+			pivotX, pivotY,
+			0, 0,
+			width, height,
+			true, true
+		};
+	}
+
+	SDL_Rect Layout::resolve(int screenWidth, int screenHeight) const {
+		//Fixed sizes scale by whichever axis has shrunk the most, so that
+		// artwork keeps its aspect ratio and always fits
+		float scale = std::min(
+			(float)screenWidth / util::SCREEN_WIDTH,
+			(float)screenHeight / util::SCREEN_HEIGHT);
+
+		float w = this->relativeWidth ? this->width * screenWidth : this->width * scale;
+		float h = this->relativeHeight ? this->height * screenHeight : this->height * scale;
+		float x = this->anchorX * screenWidth + this->offsetX * scale - this->pivotX * w;
+		float y = this->anchorY * screenHeight + this->offsetY * scale - this->pivotY * h;
+
+		return {
+			(int)std::lround(x),
+			(int)std::lround(y),
+			(int)std::lround(w),
+			(int)std::lround(h)
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include <SDL.h>
+#include <iostream>
+
+//Define the GUI namespace
+namespace GUI {
+
+	/* Describes where a Displayable sits on screen independently of the
+	*   window's size, so its rect can be recomputed whenever the window is
+	*   resized.
+	*
+	*  A Displayable is pinned by its pivot (a point on the Displayable,
+	*   given as fractions of its own size) to an anchor (a point on the
+	*   screen, given as fractions of the screen's size). For example, an
+	*   anchor and pivot of (0.5, 0.5) centres it. Sizes are either relative
+	*   (fractions of the screen) or fixed, in which case they are given in
+	*   pixels at the design size (util::SCREEN_WIDTH x util::SCREEN_HEIGHT)
+	*   and scaled uniformly with the screen so artwork keeps its aspect.
+	*/
+	struct Layout {
+		float anchorX, anchorY; //The point on screen the Displayable is pinned to
+		float pivotX, pivotY; //The point of the Displayable placed on the anchor
+		int offsetX, offsetY; //A further offset in design pixels
+		float width, height; //The size, see relativeWidth/relativeHeight
+		bool relativeWidth; //Whether width is a fraction of the screen's width
+		bool relativeHeight; //Whether height is a fraction of the screen's height
+
+		/*Creates a layout with a size given in design pixels
+		*
+		* Params:
+		* - anchorX, anchorY - the point on screen, as fractions of its size
+		* - pivotX, pivotY - the point of the Displayable, as fractions of its size
+		* - width, height - the size in pixels at the design size
+		*/
+		static Layout fixed(float anchorX, float anchorY,
+			float pivotX, float pivotY, int width, int height);
+
+		/*Creates a layout with a size given as fractions of the screen
+		*
+		* Params:
+		* - anchorX, anchorY - the point on screen, as fractions of its size
+		* - pivotX, pivotY - the point of the Displayable, as fractions of its size
+		* - width, height - the size as fractions of the screen's size
+		*/
+		static Layout relative(float anchorX, float anchorY,
+			float pivotX, float pivotY, float width, float height);
+
+		/*Computes the rect the Displayable occupies on a screen
+		*
+		* Preconditions:
+		* - screenWidth > 0, screenHeight > 0
+		*
+		* Returns the rect, in screen pixels
+		*/
+		SDL_Rect resolve(int screenWidth, int screenHeight) const;
+	};
+}
+
+#endif
\ No newline at end of file
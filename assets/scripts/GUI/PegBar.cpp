@@ -1,84 +1,169 @@
 #include <SDL.h>
 #include <iostream>
-#include <map>
 #include <vector>
 #include <stdint.h>
 
+#include "../utils.h"
+#include "../intern.h"
 #include "./Displayable.h"
+#include "./AssetIndex.h"
+#include "./HitGrid.h"
 #include "./Layering.h"
+#include "./Profiler.h"
 
 using std::string;
+using util::StrID;
 
 namespace GUI {
 	//Private
-	bool PegBar::layerExists(uint16_t i) const { return i < this->layers.size(); }
-	uint16_t PegBar::countLayers() const { return this->layers.size(); }
+	bool PegBar::layerExists(uint16_t i) const { return i < this->order.size(); }
+	uint16_t PegBar::countLayers() const { return this->order.size(); }
+
+	void PegBar::rebuildRanks() {
+		this->rank.resize(this->order.size());
+		for (int x = 0; x < this->order.size(); x++)
+			this->rank[this->order[x]] = x;
+	}
+
+	void PegBar::dropCache(Layer& layer) {
+		if (layer.cache != nullptr) SDL_DestroyTexture(layer.cache);
+		layer.cache = nullptr;
+		layer.stale = true;
+	}
+
+	bool PegBar::renderAssets(SDL_Renderer* renderer, const Layer& layer, uint32_t& draws) {
+		bool failed = false;
+		for (int y = 0; y < layer.assets.size(); y++) {
+			bool success = layer.assets[y]->render(renderer);
+			if (!success) {
+				this->error = layer.assets[y]->getError();
+				failed = true;
+			}
+			else draws++;
+		}
+		return !failed;
+	}
+
+	bool PegBar::refreshCache(SDL_Renderer* renderer, Layer& layer, bool& failed, uint32_t& draws) {
+		//Create the cache the first time the layer is drawn
+		if (layer.cache == nullptr) {
+			layer.cache = SDL_CreateTexture(
+				renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+				util::getScreenWidth(), util::getScreenHeight());
+			if (layer.cache == nullptr) return false;
+
+			//Drawing with blending into a transparent texture leaves it with
+			// premultiplied alpha, so it must be blitted as such. Fall back
+			// to plain blending where custom modes are unsupported
+			SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+				SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+				SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+			if (SDL_SetTextureBlendMode(layer.cache, premultiplied) != 0)
+				SDL_SetTextureBlendMode(layer.cache, SDL_BLENDMODE_BLEND);
+			layer.stale = true;
+		}
+		if (!layer.stale) return true;
+
+		//Redraw the layer into the cache, restoring whatever target was set
+		SDL_Texture* target = SDL_GetRenderTarget(renderer);
+		if (SDL_SetRenderTarget(renderer, layer.cache) != 0) {
+			dropCache(layer);
+			return false;
+		}
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+		SDL_RenderClear(renderer);
+		if (!this->renderAssets(renderer, layer, draws)) failed = true;
+		SDL_SetRenderTarget(renderer, target);
+
+		layer.stale = false;
+		return true;
+	}
+
+	void PegBar::releaseSlot(uint32_t slot, bool wipeAsset) {
+		AssetSlot& entry = this->slots[slot];
+		Layer& layer = this->layers[entry.layer];
+		layer.stale = true;
+
+		//Swap the last asset of the layer into the vacated position
+		uint32_t last = layer.assets.size() - 1;
+		if (entry.pos != last) {
+			layer.assets[entry.pos] = layer.assets[last];
+			layer.slots[entry.pos] = layer.slots[last];
+			this->slots[layer.slots[entry.pos]].pos = entry.pos;
+		}
+		layer.assets.pop_back();
+		layer.slots.pop_back();
+
+		//Take the Displayable off the grid, then destroy it if applicable or
+		// detach it from this structure OW
+		this->grid.remove(slot);
+		if (wipeAsset) delete entry.disp;
+		else entry.disp->setOwner(nullptr, 0);
+		this->index.erase(entry.key);
+		entry.disp = nullptr;
+		entry.key = util::STR_INVALID;
+		entry.generation++;
+		this->freeSlots.push_back(slot);
+	}
 
 	//Public
 	uint16_t PegBar::makeLayer(uint16_t i) {
 		//Store the index, may be changed later
 		uint16_t index = i;
-		//Check whether the layer already exists
-		bool exists = this->layerExists(i);
-
-		//Create new entries in the layer and layer key structures
-		this->layers.push_back(std::map<string, Displayable*>());
-		this->layerKeys.push_back(std::vector<string>());
-
-		//If the layer already exists, shift everything backward one
-		if (exists) {
-			//Swap the maps at the locations until the new entry reaches
-			// the desired spot
-			for (int x = this->layers.size() - 1; x > i; x--) {
-				std::map<string, Displayable*> tempL = this->layers[x];
-				this->layers[x] = this->layers[x - 1];
-				this->layers[x - 1] = tempL;
-
-				std::vector<string> tempK = this->layerKeys[x];
-				this->layerKeys[x] = this->layerKeys[x - 1];
-				this->layerKeys[x - 1] = tempK;
-			}
+
+		//Create a new entry in the layer storage
+		uint16_t storage = this->layers.size();
+		this->layers.push_back(Layer());
+
+		//If the layer already exists, insert the new entry at i so that
+		// everything above is shifted up one. Only indexes are moved
+		if (this->layerExists(i))
+			this->order.insert(this->order.begin() + i, storage);
+
+		//If the layer does not exist, place the new entry on top
+		else {
+			this->order.push_back(storage);
+			index = this->order.size() - 1;
 		}
 
-		//If the layer does not exist, return the index of the new cell
-		else index = this->layers.size() - 1;
+		this->rebuildRanks();
 
 		//Return the true index of the new layer
 		return index;
 	}
-	
+
 	bool PegBar::dropLayer(uint16_t i, bool wipeAssets) {
 		if (!this->layerExists(i)) {
 			this->error = "PegBar.dropLayer(): Layer cannot be removed, does not exist";
 			return false;
 		}
 
-		//Swap the locations forward until the target layer is on the top of
-		// the structure
-		for (int x = i; x < this->layers.size() - 1; x++) {
-			std::map<string, Displayable*> tempL = this->layers[x];
-			this->layers[x] = this->layers[x + 1];
-			this->layers[x + 1] = tempL;
+		//Release every asset on the layer, destroying them if applicable
+		uint16_t storage = this->order[i];
+		while (!this->layers[storage].slots.empty())
+			this->releaseSlot(this->layers[storage].slots.back(), wipeAssets);
+		dropCache(this->layers[storage]);
 
-			std::vector<string> tempK = this->layerKeys[x];
-			this->layerKeys[x] = this->layerKeys[x + 1];
-			this->layerKeys[x + 1] = tempK;
-		}
+		//Remove the layer from the render order
+		this->order.erase(this->order.begin() + i);
 
-		//Destroy the contents of the layers box if applicable
-		if (wipeAssets) {
-			uint16_t t = this->layers.size() - 1;
-			for (int x = 0; x < this->layerKeys[t].size(); x++)
-				delete this->layers[t][this->layerKeys[t][x]];
+		//Move the last storage entry into the emptied one so storage stays
+		// dense, then repoint everything that referred to it
+		uint16_t last = this->layers.size() - 1;
+		if (storage != last) {
+			this->layers[storage] = std::move(this->layers[last]);
+			for (int x = 0; x < this->layers[storage].slots.size(); x++)
+				this->slots[this->layers[storage].slots[x]].layer = storage;
+			for (int x = 0; x < this->order.size(); x++)
+				if (this->order[x] == last) this->order[x] = storage;
 		}
-
-		//Pop the final layer off of the structure
 		this->layers.pop_back();
-		this->layerKeys.pop_back();
+
+		this->rebuildRanks();
 
 		return true;
 	}
-	
+
 	bool PegBar::insertIntoLayer(string key, Displayable* disp, uint16_t i) {
 		//Ensure that the layer already exists
 		if (!layerExists(i)) {
@@ -87,11 +172,11 @@ namespace GUI {
 		}
 
 		//Ensure that the key is not already in use
-		for (int x = 0; x < this->layers.size(); x++)
-			if (this->layers[x].count(key)) {
-				this->error = "PegBar.insertIntoLayer(): Key already in use";
-				return false;
-			}
+		StrID id = util::intern(key);
+		if (this->isValid(this->index.find(id))) {
+			this->error = "PegBar.insertIntoLayer(): Key already in use";
+			return false;
+		}
 
 		//Ensure that the displayable is not null
 		if (disp == nullptr) {
@@ -99,90 +184,239 @@ namespace GUI {
 			return false;
 		}
 
-		//Insert the Displayable pointer into the layers table with its key
-		this->layers[i].insert(std::pair<string, Displayable*>(key, disp));
-		//Insert the key into the layerKey list
-		this->layerKeys[i].push_back(key);
+		//Take a free slot if there is one, otherwise grow the table
+		uint32_t slot;
+		if (!this->freeSlots.empty()) {
+			slot = this->freeSlots.back();
+			this->freeSlots.pop_back();
+		} else {
+			slot = this->slots.size();
+			this->slots.push_back({ nullptr, util::STR_INVALID, 0, 0, 0 });
+		}
+
+		//Append the Displayable to the end of the layer
+		uint16_t storage = this->order[i];
+		Layer& layer = this->layers[storage];
+		layer.assets.push_back(disp);
+		layer.slots.push_back(slot);
+		layer.stale = true;
+
+		//Fill in the slot and record its handle in the index
+		AssetSlot& entry = this->slots[slot];
+		entry.disp = disp;
+		entry.key = id;
+		entry.layer = storage;
+		entry.pos = layer.assets.size() - 1;
+		this->index.insert(id, { slot, entry.generation });
+
+		//Let the Displayable report changes, and make it findable by the mouse
+		disp->setOwner(this, slot);
+		if (disp->isInteractive()) this->grid.insert(slot, disp->getRect_Dynamic());
 
 		return true;
 	}
-	
+
 	bool PegBar::removeAsset(string key, bool wipeAsset) {
-		//Get the layer index of the asset being removed
-		int32_t i = this->getLayerByKey(key);
-		if (i == -1) {
+		return this->removeAsset(this->getHandle(key), wipeAsset);
+	}
+
+	bool PegBar::removeAsset(StrID key, bool wipeAsset) {
+		return this->removeAsset(this->getHandle(key), wipeAsset);
+	}
+
+	bool PegBar::removeAsset(AssetHandle handle, bool wipeAsset) {
+		//Ensure the asset being removed is present
+		if (!this->isValid(handle)) {
 			this->error = "PegBar.removeAsset(): Asset not found";
 			return false;
 		}
 
-		//Remove the index from the layer
-		if (wipeAsset) delete this->layers[i][key];
-		this->layers[i].erase(key);
+		this->releaseSlot(handle.index, wipeAsset);
+		return true;
+	}
+
+	bool PegBar::setLayerStatic(uint16_t i, bool isStatic) {
+		if (!this->layerExists(i)) {
+			this->error = "PegBar.setLayerStatic(): Layer does not exist";
+			return false;
+		}
+
+		Layer& layer = this->layers[this->order[i]];
+		layer.isStatic = isStatic;
+		if (!isStatic) dropCache(layer);
+		return true;
+	}
 
-		//Remove the key from the key list
-		int del = -1;
-		for (int x = 0; x < this->layerKeys[i].size() - 1; x++)
-			if (this->layerKeys[i][x] == key) { del = x; break; }
+	bool PegBar::isLayerStatic(uint16_t i) const {
+		return this->layerExists(i) && this->layers[this->order[i]].isStatic;
+	}
 
-		//Swap the target Displayable
-		this->layerKeys[i][del] = this->layerKeys[i][this->layerKeys[i].size() - 1];
-		this->layerKeys.pop_back();
+	bool PegBar::invalidateLayer(uint16_t i) {
+		if (!this->layerExists(i)) {
+			this->error = "PegBar.invalidateLayer(): Layer does not exist";
+			return false;
+		}
 
+		this->layers[this->order[i]].stale = true;
 		return true;
 	}
-	
+
+	void PegBar::resetTargets(bool recreate) {
+		for (uint16_t x = 0; x < this->order.size(); x++) {
+			Layer& layer = this->layers[this->order[x]];
+			if (recreate) dropCache(layer);
+			else this->invalidateLayer(x);
+
+			for (int y = 0; y < layer.assets.size(); y++)
+				layer.assets[y]->resetScaled();
+		}
+	}
+
+	void PegBar::resize(int width, int height) {
+		this->grid.resize(width, height, (height >= 8) ? height / 8 : 1);
+
+		//The caches are screen-sized, so they are rebuilt at the new size
+		for (int x = 0; x < this->layers.size(); x++) {
+			Layer& layer = this->layers[x];
+			dropCache(layer);
+			for (int y = 0; y < layer.assets.size(); y++)
+				layer.assets[y]->relayout(width, height);
+		}
+	}
+
 	bool PegBar::render(SDL_Renderer* renderer) {
 		bool failed = false;
 
+		Profiler& profiler = Profiler::instance();
+
 		//Iterate through each layer in the structure
-		for (int x = 0; x < this->layers.size(); x++) {
-			//For each layer, iterate through the Displayables and render them
-			for (int y = 0; y < this->layerKeys[x].size(); y++) {
-				string currKey = this->layerKeys[x][y];
-				bool success = this->layers[x][currKey]->render(renderer);
-				if (!success) {
-					this->error = this->layers[x][currKey]->getError();
-					bool failed = true;
-				}
+		for (int x = 0; x < this->order.size(); x++) {
+			Layer& layer = this->layers[this->order[x]];
+			uint64_t start = Profiler::now();
+			uint32_t draws = 0;
+
+			//Blit static layers from their cache, redrawing it if needed
+			if (layer.isStatic && this->refreshCache(renderer, layer, failed, draws)) {
+				SDL_RenderCopy(renderer, layer.cache, NULL, NULL);
+				draws++;
 			}
+
+			//For each other layer, render the Displayables directly
+			else if (!this->renderAssets(renderer, layer, draws)) failed = true;
+
+			profiler.recordLayer(x, start, Profiler::now(), draws, layer.isStatic);
 		}
 
 		//Return the opposite of whether it failed
 		return !failed;
 	}
-	
+
 	Displayable* PegBar::getAssetByKey(string key) {
-		//Access the index of the layer containing the Displayable
-		int32_t l = this->getLayerByKey(key);
-		//If there was no layer found, return nullptr
-		if (l == -1) {
+		return this->getAssetByKey(util::findInterned(key));
+	}
+
+	Displayable* PegBar::getAssetByKey(StrID key) {
+		//Find the handle of the Displayable in the index
+		AssetHandle handle = this->index.find(key);
+		//If there was no entry found, return nullptr
+		if (!this->isValid(handle)) {
 			this->error = "PegBar.getAssetByKey(): Cannot find key";
 			return nullptr;
 		}
 
 		//Return the pointer associated with the key
-		return this->layers[l][key];
+		return this->slots[handle.index].disp;
+	}
+
+	AssetHandle PegBar::getHandle(string key) const {
+		return this->getHandle(util::findInterned(key));
+	}
+
+	AssetHandle PegBar::getHandle(StrID key) const { return this->index.find(key); }
+
+	bool PegBar::isValid(AssetHandle handle) const {
+		return handle.index < this->slots.size()
+			&& this->slots[handle.index].disp != nullptr
+			&& this->slots[handle.index].generation == handle.generation;
 	}
-	
+
+	Displayable* PegBar::getAsset(AssetHandle handle) {
+		if (!this->isValid(handle)) {
+			this->error = "PegBar.getAsset(): Handle is not valid";
+			return nullptr;
+		}
+		return this->slots[handle.index].disp;
+	}
+
 	int32_t PegBar::getLayerByKey(string key) const {
-		//Initialize the index to a null value
-		int32_t index = -1;
-		//Iterate through to find the index of the provided key
-		for (int x = 0; x < this->layers.size(); x++)
-			if (this->layers[x].count(key)) index = x;
-		//Return the index. If not found, this value will remain -1
-		return index;
+		return this->getLayerByHandle(this->getHandle(key));
+	}
+
+	int32_t PegBar::getLayerByKey(StrID key) const {
+		return this->getLayerByHandle(this->getHandle(key));
+	}
+
+	int32_t PegBar::getLayerByHandle(AssetHandle handle) const {
+		//Return the index of the layer. If the handle is stale, return -1
+		if (!this->isValid(handle)) return -1;
+		return this->rank[this->slots[handle.index].layer];
 	}
-	
+
+	AssetHandle PegBar::hitTest(int x, int y) const {
+		AssetHandle best = ASSET_NULL;
+		uint16_t bestRank = 0;
+		uint32_t bestPos = 0;
+
+		//Only the Displayables sharing the point's cell can contain it
+		const std::vector<uint32_t>& candidates = this->grid.query(x, y);
+		for (int i = 0; i < candidates.size(); i++) {
+			const AssetSlot& entry = this->slots[candidates[i]];
+			if (!util::rectContains(entry.disp->getRect_Dynamic(), x, y)) continue;
+
+			//Keep whichever is rendered last
+			uint16_t rank = this->rank[entry.layer];
+			bool above = rank > bestRank || (rank == bestRank && entry.pos > bestPos);
+			if (best == ASSET_NULL || above) {
+				best = { candidates[i], entry.generation };
+				bestRank = rank;
+				bestPos = entry.pos;
+			}
+		}
+
+		return best;
+	}
+
+	void PegBar::assetMoved(uint32_t slot) {
+		if (this->grid.contains(slot))
+			this->grid.insert(slot, this->slots[slot].disp->getRect_Dynamic());
+		this->layers[this->slots[slot].layer].stale = true;
+	}
+
+	void PegBar::assetChanged(uint32_t slot) {
+		this->layers[this->slots[slot].layer].stale = true;
+	}
+
 	string PegBar::getError() const { return this->error; }
 
 	std::vector<string> PegBar::getKeys() const {
 		std::vector<string> keycomp;
 
-		for (int x = 0; x < this->layerKeys.size(); x++)
-			for (int y = 0; y < this->layerKeys[x].size(); y++)
-				keycomp.push_back(this->layerKeys[x][y]);
+		for (int x = 0; x < this->order.size(); x++) {
+			const Layer& layer = this->layers[this->order[x]];
+			for (int y = 0; y < layer.slots.size(); y++)
+				keycomp.push_back(util::unintern(this->slots[layer.slots[y]].key));
+		}
 
 		return keycomp;
 	}
+
+	void PegBar::getKeyIDs(std::vector<StrID>& out) const {
+		out.clear();
+
+		for (int x = 0; x < this->order.size(); x++) {
+			const Layer& layer = this->layers[this->order[x]];
+			for (int y = 0; y < layer.slots.size(); y++)
+				out.push_back(this->slots[layer.slots[y]].key);
+		}
+	}
 }
\ No newline at end of file
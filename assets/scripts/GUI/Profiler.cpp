@@ -0,0 +1,311 @@
+#include <SDL.h>
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+
+#include "./Profiler.h"
+
+namespace GUI {
+	//The names phases are written out with, indexed by ProfilePhase
+	static const char* PHASE_NAMES[PHASE_COUNT] = {
+		"events", "upload", "update", "render", "present", "transition"
+	};
+
+	//The colors phases are drawn with in the overlay, indexed by ProfilePhase
+	static const SDL_Color PHASE_COLORS[PHASE_COUNT] = {
+		{ 0x5B, 0x8D, 0xEF, 0xFF },
+		{ 0xB0, 0x6A, 0xE8, 0xFF },
+		{ 0x4C, 0xC2, 0x7A, 0xFF },
+		{ 0xF0, 0x9A, 0x3E, 0xFF },
+		{ 0x9A, 0x9A, 0x9A, 0xFF },
+		{ 0xE0, 0x4F, 0x5F, 0xFF }
+	};
+
+	//The overlay's graph spans this many milliseconds over GRAPH_HEIGHT pixels
+	static const double GRAPH_MS = 1000.0 / 30;
+	static const int GRAPH_HEIGHT = 100;
+	//The number of recent frames the overlay averages over
+	static const int AVERAGE_FRAMES = 60;
+
+	//A 3x5 pixel font for the overlay's numbers. Each glyph is five rows of
+	// three bits, most significant bit on the left
+	static const uint8_t DIGITS[10][5] = {
+		{ 7, 5, 5, 5, 7 }, { 2, 6, 2, 2, 7 }, { 7, 1, 7, 4, 7 }, { 7, 1, 7, 1, 7 },
+		{ 5, 5, 7, 1, 1 }, { 7, 4, 7, 1, 7 }, { 7, 4, 7, 5, 7 }, { 7, 1, 1, 1, 1 },
+		{ 7, 5, 7, 5, 7 }, { 7, 5, 7, 1, 7 }
+	};
+	static const uint8_t POINT[5] = { 0, 0, 0, 0, 2 };
+	static const int GLYPH_SCALE = 2;
+
+	//Draws the digits, points and spaces of text at (x, y) in the current color
+	static void drawText(SDL_Renderer* renderer, int x, int y, const char* text) {
+		for (; *text != '\0'; text++, x += 4 * GLYPH_SCALE) {
+			const uint8_t* glyph = nullptr;
+			if (*text >= '0' && *text <= '9') glyph = DIGITS[*text - '0'];
+			else if (*text == '.') glyph = POINT;
+			if (glyph == nullptr) continue;
+
+			for (int row = 0; row < 5; row++) {
+				for (int col = 0; col < 3; col++) {
+					if (!(glyph[row] & (4 >> col))) continue;
+					SDL_Rect px = {
+						x + col * GLYPH_SCALE, y + row * GLYPH_SCALE,
+						GLYPH_SCALE, GLYPH_SCALE
+					};
+					SDL_RenderFillRect(renderer, &px);
+				}
+			}
+		}
+	}
+
+	//Draws a small square of a color, used to label the overlay's rows
+	static void drawSwatch(SDL_Renderer* renderer, int x, int y, SDL_Color color) {
+		SDL_Rect swatch = { x, y, 5 * GLYPH_SCALE, 5 * GLYPH_SCALE };
+		SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+		SDL_RenderFillRect(renderer, &swatch);
+	}
+
+	//Private
+	Profiler::Profiler() {
+		std::memset(this->frames, 0, sizeof(this->frames));
+		this->head = 0;
+		this->count = 0;
+		this->recording = false;
+		this->overlay = false;
+
+		this->frequency = SDL_GetPerformanceFrequency();
+		this->origin = now();
+	}
+
+	double Profiler::toMs(uint64_t ticks) const {
+		return (double)ticks * 1000.0 / (double)this->frequency;
+	}
+
+	const Profiler::Frame& Profiler::frame(uint32_t i) const {
+		return this->frames[(this->head + PROFILE_FRAMES - this->count + i) % PROFILE_FRAMES];
+	}
+
+	//Public
+	Profiler& Profiler::instance() {
+		static Profiler profiler;
+		return profiler;
+	}
+
+	void Profiler::beginFrame() {
+		Frame& curr = this->frames[this->head];
+		curr.start = now();
+		curr.end = curr.start;
+		for (int x = 0; x < PHASE_COUNT; x++) {
+			curr.phaseStart[x] = 0;
+			curr.phaseEnd[x] = 0;
+		}
+		curr.layerCount = 0;
+		this->recording = true;
+	}
+
+	void Profiler::endFrame() {
+		if (!this->recording) return;
+
+		this->frames[this->head].end = now();
+		this->head = (this->head + 1) % PROFILE_FRAMES;
+		if (this->count < PROFILE_FRAMES) this->count++;
+		this->recording = false;
+	}
+
+	void Profiler::beginPhase(ProfilePhase phase) {
+		if (this->recording) this->frames[this->head].phaseStart[phase] = now();
+	}
+
+	void Profiler::endPhase(ProfilePhase phase) {
+		if (this->recording) this->frames[this->head].phaseEnd[phase] = now();
+	}
+
+	void Profiler::recordLayer(uint16_t layer, uint64_t start, uint64_t end,
+		uint32_t draws, bool cached) {
+		if (!this->recording) return;
+
+		Frame& curr = this->frames[this->head];
+		if (curr.layerCount >= PROFILE_LAYERS) return;
+		curr.layers[curr.layerCount++] = { layer, cached, draws, start, end };
+	}
+
+	uint32_t Profiler::lastFrameDraws() const {
+		if (this->count == 0) return 0;
+
+		const Frame& last = this->frame(this->count - 1);
+		uint32_t draws = 0;
+		for (uint16_t x = 0; x < last.layerCount; x++) draws += last.layers[x].draws;
+		return draws;
+	}
+
+	void Profiler::toggleOverlay() { this->overlay = !this->overlay; }
+
+	bool Profiler::isOverlayShown() const { return this->overlay; }
+
+	void Profiler::renderOverlay(SDL_Renderer* renderer) {
+		if (!this->overlay) return;
+
+		//Average each phase, and the frame as a whole, over recent frames
+		uint32_t averaged = (this->count < AVERAGE_FRAMES) ? this->count : AVERAGE_FRAMES;
+		double phaseMs[PHASE_COUNT] = { 0 };
+		double frameMs = 0;
+		for (uint32_t i = this->count - averaged; i < this->count; i++) {
+			const Frame& f = this->frame(i);
+			frameMs += this->toMs(f.end - f.start);
+			for (int p = 0; p < PHASE_COUNT; p++)
+				phaseMs[p] += this->toMs(f.phaseEnd[p] - f.phaseStart[p]);
+		}
+		if (averaged > 0) {
+			frameMs /= averaged;
+			for (int p = 0; p < PHASE_COUNT; p++) phaseMs[p] /= averaged;
+		}
+		const Frame* last = (this->count > 0) ? &this->frame(this->count - 1) : nullptr;
+		int layerRows = (last != nullptr) ? last->layerCount : 0;
+
+		//Draw a translucent panel to hold everything
+		int rowHeight = 7 * GLYPH_SCALE;
+		int left = 8, top = 8;
+		int graphTop = top + 8;
+		int textTop = graphTop + GRAPH_HEIGHT + 8;
+		SDL_Rect panel = {
+			left, top, PROFILE_FRAMES + 16,
+			(textTop - top) + (PHASE_COUNT + 1 + layerRows) * rowHeight + 8
+		};
+		SDL_BlendMode blend;
+		SDL_GetRenderDrawBlendMode(renderer, &blend);
+		SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+		SDL_SetRenderDrawColor(renderer, 0x10, 0x10, 0x18, 0xC0);
+		SDL_RenderFillRect(renderer, &panel);
+
+		//Stack each frame's phases into a bar, oldest on the left
+		double pxPerMs = GRAPH_HEIGHT / GRAPH_MS;
+		for (uint32_t i = 0; i < this->count; i++) {
+			const Frame& f = this->frame(i);
+			int x = left + 8 + (PROFILE_FRAMES - this->count) + i;
+			int base = graphTop + GRAPH_HEIGHT;
+			for (int p = 0; p < PHASE_COUNT && base > graphTop; p++) {
+				int h = (int)(this->toMs(f.phaseEnd[p] - f.phaseStart[p]) * pxPerMs + 0.5);
+				if (h <= 0) continue;
+				if (base - h < graphTop) h = base - graphTop;
+				SDL_Rect bar = { x, base - h, 1, h };
+				const SDL_Color& c = PHASE_COLORS[p];
+				SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+				SDL_RenderFillRect(renderer, &bar);
+				base -= h;
+			}
+		}
+
+		//Mark the 60 FPS budget
+		int budget = graphTop + GRAPH_HEIGHT - (int)(1000.0 / 60 * pxPerMs + 0.5);
+		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0x80);
+		SDL_RenderDrawLine(renderer, left + 8, budget, left + 8 + PROFILE_FRAMES, budget);
+
+		//List the average time of each phase, then of the whole frame
+		char text[32];
+		int y = textTop;
+		for (int p = 0; p < PHASE_COUNT; p++, y += rowHeight) {
+			drawSwatch(renderer, left + 8, y, PHASE_COLORS[p]);
+			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			std::snprintf(text, sizeof(text), "%.2f", phaseMs[p]);
+			drawText(renderer, left + 24, y, text);
+		}
+		drawSwatch(renderer, left + 8, y, { 0xFF, 0xFF, 0xFF, 0xFF });
+		std::snprintf(text, sizeof(text), "%.2f", frameMs);
+		drawText(renderer, left + 24, y, text);
+		y += rowHeight;
+
+		//List the last frame's layers: index, time and draw calls. Static
+		// layers are marked with a lighter swatch
+		for (int l = 0; l < layerRows; l++, y += rowHeight) {
+			const LayerSample& s = last->layers[l];
+			SDL_Color shade = s.cached
+				? SDL_Color{ 0xD8, 0xCC, 0xE3, 0xFF } : SDL_Color{ 0x60, 0x60, 0x70, 0xFF };
+			drawSwatch(renderer, left + 8, y, shade);
+			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			std::snprintf(text, sizeof(text), "%u %.3f %u",
+				(unsigned)s.layer, this->toMs(s.end - s.start), (unsigned)s.draws);
+			drawText(renderer, left + 24, y, text);
+		}
+
+		SDL_SetRenderDrawBlendMode(renderer, blend);
+	}
+
+	bool Profiler::writeCSV(const char* path) const {
+		std::ofstream out(path);
+		if (!out) return false;
+
+		out << "frame,kind,name,start_ms,duration_ms,draws\n";
+		char row[128];
+		for (uint32_t i = 0; i < this->count; i++) {
+			const Frame& f = this->frame(i);
+			std::snprintf(row, sizeof(row), "%u,frame,frame,%.4f,%.4f,\n", i,
+				this->toMs(f.start - this->origin), this->toMs(f.end - f.start));
+			out << row;
+
+			for (int p = 0; p < PHASE_COUNT; p++) {
+				if (f.phaseStart[p] == 0) continue;
+				std::snprintf(row, sizeof(row), "%u,phase,%s,%.4f,%.4f,\n", i, PHASE_NAMES[p],
+					this->toMs(f.phaseStart[p] - this->origin),
+					this->toMs(f.phaseEnd[p] - f.phaseStart[p]));
+				out << row;
+			}
+
+			for (int l = 0; l < f.layerCount; l++) {
+				const LayerSample& s = f.layers[l];
+				std::snprintf(row, sizeof(row), "%u,layer,%s%u,%.4f,%.4f,%u\n", i,
+					s.cached ? "static" : "layer", (unsigned)s.layer,
+					this->toMs(s.start - this->origin), this->toMs(s.end - s.start),
+					(unsigned)s.draws);
+				out << row;
+			}
+		}
+
+		return (bool)out;
+	}
+
+	bool Profiler::writeTrace(const char* path) const {
+		std::ofstream out(path);
+		if (!out) return false;
+
+		//Complete ("X") events nest by time, so layers appear under render
+		out << "{\"traceEvents\":[\n";
+		char event[192];
+		bool first = true;
+		for (uint32_t i = 0; i < this->count; i++) {
+			const Frame& f = this->frame(i);
+			std::snprintf(event, sizeof(event),
+				"%s{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+				"\"ts\":%.1f,\"dur\":%.1f}",
+				first ? "" : ",\n",
+				this->toMs(f.start - this->origin) * 1000, this->toMs(f.end - f.start) * 1000);
+			out << event;
+			first = false;
+
+			for (int p = 0; p < PHASE_COUNT; p++) {
+				if (f.phaseStart[p] == 0) continue;
+				std::snprintf(event, sizeof(event),
+					",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+					"\"ts\":%.1f,\"dur\":%.1f}",
+					PHASE_NAMES[p], this->toMs(f.phaseStart[p] - this->origin) * 1000,
+					this->toMs(f.phaseEnd[p] - f.phaseStart[p]) * 1000);
+				out << event;
+			}
+
+			for (int l = 0; l < f.layerCount; l++) {
+				const LayerSample& s = f.layers[l];
+				std::snprintf(event, sizeof(event),
+					",\n{\"name\":\"%s %u\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+					"\"ts\":%.1f,\"dur\":%.1f,\"args\":{\"draws\":%u}}",
+					s.cached ? "static layer" : "layer", (unsigned)s.layer,
+					this->toMs(s.start - this->origin) * 1000,
+					this->toMs(s.end - s.start) * 1000, (unsigned)s.draws);
+				out << event;
+			}
+		}
+		out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+		return (bool)out;
+	}
+}
\ No newline at end of file
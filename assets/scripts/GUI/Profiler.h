@@ -0,0 +1,130 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <SDL.h>
+#include <iostream>
+#include <stdint.h>
+
+namespace GUI {
+
+	//The phases of the main loop that are timed every frame
+	enum ProfilePhase {
+		PHASE_EVENTS, //Polling and handling SDL events
+		PHASE_UPLOAD, //Uploading textures from the AssetLoader
+		PHASE_UPDATE, //Level::update()
+		PHASE_RENDER, //Clearing the window and Level::render()
+		PHASE_PRESENT, //SDL_RenderPresent()
+		PHASE_TRANSITION, //Acting on level transitions
+		PHASE_COUNT
+	};
+
+	//The number of frames kept for the overlay and trace files
+	static const int PROFILE_FRAMES = 240;
+	//The most PegBar layers recorded per frame, later ones are dropped
+	static const int PROFILE_LAYERS = 16;
+
+	/* Records how long each frame spends in each phase of the main loop,
+	*   and how long each PegBar layer takes to render and how many draw calls
+	*   it makes. Samples go into a fixed ring of the most recent frames, so
+	*   recording allocates nothing and costs a few counter reads per frame.
+	*
+	*  The ring can be drawn as an overlay (stacked frame-time bars plus the
+	*   averages and the last frame's layers) or written out as CSV or as
+	*   Chrome trace JSON, which chrome://tracing and Perfetto can open.
+	*/
+	class Profiler {
+	private:
+		struct LayerSample {
+			uint16_t layer; //The index of the layer in its PegBar
+			bool cached; //Whether the layer is static
+			uint32_t draws; //Draw calls made for the layer
+			uint64_t start, end; //Performance counter readings
+		};
+
+		struct Frame {
+			uint64_t start, end;
+			uint64_t phaseStart[PHASE_COUNT], phaseEnd[PHASE_COUNT];
+			uint16_t layerCount;
+			LayerSample layers[PROFILE_LAYERS];
+		};
+
+		Frame frames[PROFILE_FRAMES];
+		uint32_t head; //The slot of the frame being recorded
+		uint32_t count; //The number of completed frames held
+		bool recording; //Whether a frame has begun and not yet ended
+		bool overlay; //Whether the overlay is drawn
+
+		uint64_t frequency; //Performance counter ticks per second
+		uint64_t origin; //The counter reading all times are relative to
+
+		//Converts a span of counter ticks into milliseconds
+		double toMs(uint64_t ticks) const;
+
+		//Accesses a completed frame, 0 being the oldest held
+		const Frame& frame(uint32_t i) const;
+
+		Profiler();
+
+	public:
+		//Accesses the process-wide profiler
+		static Profiler& instance();
+
+		//Reads the performance counter
+		static uint64_t now() { return SDL_GetPerformanceCounter(); }
+
+		/*Mark the start and end of a frame. Samples recorded outside of a
+		*  frame are ignored.
+		*/
+		void beginFrame();
+		void endFrame();
+
+		/*Mark the start and end of a main-loop phase within the frame*/
+		void beginPhase(ProfilePhase phase);
+		void endPhase(ProfilePhase phase);
+
+		/*Records the rendering of one PegBar layer
+		*
+		* Params:
+		* - layer - the index of the layer
+		* - start - the counter reading when it began, see now()
+		* - end - the counter reading when it finished
+		* - draws - the number of draw calls it made
+		* - cached - whether the layer is static
+		*/
+		void recordLayer(uint16_t layer, uint64_t start, uint64_t end,
+			uint32_t draws, bool cached);
+
+		/*Finds the draw calls made across every layer in the most recently
+		*  completed frame
+		*
+		* Returns the total, 0 if no frame has completed
+		*/
+		uint32_t lastFrameDraws() const;
+
+		//Shows or hides the overlay
+		void toggleOverlay();
+		bool isOverlayShown() const;
+
+		/*Draws the overlay in the top-left corner of the current target IFF it
+		*  is shown
+		*
+		* Precondition:
+		* - renderer != nullptr
+		*/
+		void renderOverlay(SDL_Renderer* renderer);
+
+		/*Writes the frames held as CSV, one row per frame, phase and layer
+		*
+		* Returns true IFF the file was written, false OW
+		*/
+		bool writeCSV(const char* path) const;
+
+		/*Writes the frames held as Chrome trace event JSON
+		*
+		* Returns true IFF the file was written, false OW
+		*/
+		bool writeTrace(const char* path) const;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,135 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <cstring>
+#include <stdint.h>
+
+//Define the utility namespace
+namespace util {
+
+	//A compact identifier standing in for an interned string
+	typedef uint32_t StrID;
+	static const StrID STR_INVALID = 0xFFFFFFFF;
+	//The ID of util::ANONYMOUS ("_"), reserved when the table is created
+	static const StrID STR_ANONYMOUS = 0;
+
+	/* This class assigns every distinct string a compact integer ID so that
+	*   keys, poses and flags can be compared and hashed without touching the
+	*   characters. IDs are handed out sequentially and are never recycled.
+	*   The lookup table uses open addressing with linear probing, so finding
+	*   an already-interned string performs no allocation.
+	*/
+	class InternTable {
+	private:
+		//The interned strings, indexed by their ID. A deque never moves its
+		// elements when it grows, so references from lookup() stay valid
+		std::deque<std::string> strings;
+		//Open-addressed hash slots holding IDs, STR_INVALID marks an empty slot
+		std::vector<StrID> slots;
+
+		//Hashes the provided characters (FNV-1a)
+		static uint32_t hash(const char* str, size_t len) {
+			uint32_t h = 2166136261u;
+			for (size_t x = 0; x < len; x++) {
+				h ^= (uint8_t)str[x];
+				h *= 16777619u;
+			}
+			return h;
+		}
+
+		//Finds the slot holding str, or the empty slot where it would go
+		size_t probe(const char* str, size_t len) const {
+			size_t mask = this->slots.size() - 1;
+			size_t i = hash(str, len) & mask;
+			while (this->slots[i] != STR_INVALID) {
+				const std::string& curr = this->strings[this->slots[i]];
+				if (curr.size() == len && std::memcmp(curr.data(), str, len) == 0)
+					break;
+				i = (i + 1) & mask;
+			}
+			return i;
+		}
+
+		//Doubles the slot count and reinserts every ID
+		void grow() {
+			std::vector<StrID> old(this->slots.size() * 2, STR_INVALID);
+			this->slots.swap(old);
+			for (StrID id = 0; id < this->strings.size(); id++) {
+				const std::string& str = this->strings[id];
+				this->slots[this->probe(str.data(), str.size())] = id;
+			}
+		}
+
+	public:
+		InternTable() : slots(64, STR_INVALID) {
+			//Reserve STR_ANONYMOUS for the placeholder name
+			this->intern("_", 1);
+		}
+
+		/*Retrieves the ID of a string, interning it if it is new
+		*
+		* Postcondition:
+		* - lookup(intern(str)) == str
+		*
+		* Returns the ID associated with str
+		*/
+		StrID intern(const char* str, size_t len) {
+			size_t i = this->probe(str, len);
+			if (this->slots[i] != STR_INVALID) return this->slots[i];
+
+			StrID id = (StrID)this->strings.size();
+			this->strings.push_back(std::string(str, len));
+			this->slots[i] = id;
+
+			//Keep the load factor at or below one half
+			if (this->strings.size() * 2 > this->slots.size()) this->grow();
+			return id;
+		}
+
+		/*Retrieves the ID of a string without interning it
+		*
+		* Returns the ID associated with str IFF it has been interned,
+		*  STR_INVALID OW
+		*/
+		StrID find(const char* str, size_t len) const {
+			return this->slots[this->probe(str, len)];
+		}
+
+		/*Accesses the string associated with an ID. The reference stays valid
+		*  for the life of the table, as interned strings are never moved.
+		*
+		* Precondition:
+		* - id < this->size()
+		*/
+		const std::string& lookup(StrID id) const { return this->strings[id]; }
+
+		//Finds the number of strings interned so far
+		size_t size() const { return this->strings.size(); }
+	};
+
+	//Accesses the process-wide intern table
+	inline InternTable& internTable() {
+		static InternTable table;
+		return table;
+	}
+
+	/*Convenience wrappers around the process-wide intern table*/
+	inline StrID intern(const std::string& str) {
+		return internTable().intern(str.data(), str.size());
+	}
+	inline StrID intern(const char* str) {
+		return internTable().intern(str, std::strlen(str));
+	}
+	inline StrID findInterned(const std::string& str) {
+		return internTable().find(str.data(), str.size());
+	}
+	inline const std::string& unintern(StrID id) {
+		return internTable().lookup(id);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,267 @@
+#ifndef PIXELS_H
+#define PIXELS_H
+
+#include <iostream>
+#include <vector>
+#include <mutex>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+#include "../dependencies/stb_image.h"
+
+//Define the utility namespace
+namespace util {
+
+	//The most memory the decode arena keeps cached for reuse, in bytes
+	static const size_t DECODE_POOL_LIMIT = 32 * 1024 * 1024;
+
+	/* This class backs every allocation stb_image makes (see
+	*   dependencies/stb_image.cpp). Blocks are rounded up to a power of two
+	*   and, once freed, are kept on a free list for their size so the next
+	*   image of a similar size reuses them instead of going back to the
+	*   heap. Loading the same screens over and over therefore settles into
+	*   a fixed set of blocks.
+	*
+	*  Every block is preceded by a small header recording its requested
+	*   size and size class, so frees need no size. The arena also counts
+	*   the bytes handed out and not yet freed, which makes leaks visible.
+	*/
+	class DecodeArena {
+	private:
+		//Bytes reserved in front of each block. Keeps the block 16-aligned
+		static const size_t HEADER = 16;
+		//Blocks smaller than 1 << MIN_CLASS go straight to the heap
+		static const uint32_t MIN_CLASS = 12;
+		//Blocks of 1 << MAX_CLASS or more go straight to the heap
+		static const uint32_t MAX_CLASS = 30;
+		//The class recorded for blocks that bypass the free lists
+		static const uint32_t UNPOOLED = 0;
+
+		std::mutex lock;
+		//Cached blocks, indexed by size class. Each points at its header
+		std::vector<void*> freeLists[MAX_CLASS];
+		size_t live; //Requested bytes currently handed out
+		size_t pooled; //Bytes held on the free lists
+
+		//Finds the size class that fits size bytes, UNPOOLED if none does
+		static uint32_t classOf(size_t size) {
+			//Small buffers (stb_image's headers and zlib state) are cheap for
+			// the heap, and would each tie up a whole 4KB block in the pool
+			if (size < ((size_t)1 << MIN_CLASS)) return UNPOOLED;
+
+			uint32_t c = MIN_CLASS;
+			while (c < MAX_CLASS && ((size_t)1 << c) < size) c++;
+			return (c < MAX_CLASS) ? c : UNPOOLED;
+		}
+
+		//Accessors for the header in front of a block
+		static uint8_t* headerOf(void* block) { return (uint8_t*)block - HEADER; }
+		static size_t& sizeOf(uint8_t* header) { return *(size_t*)header; }
+		static uint32_t& classAt(uint8_t* header) {
+			return *(uint32_t*)(header + sizeof(size_t));
+		}
+
+	public:
+		DecodeArena() {
+			this->live = 0;
+			this->pooled = 0;
+		}
+
+		//Returns every cached block to the heap
+		~DecodeArena() { this->trim(); }
+
+		/*Allocates a block, reusing a cached one where possible
+		*
+		* Returns a pointer to the block IFF memory is available, nullptr OW
+		*/
+		void* allocate(size_t size) {
+			uint32_t c = classOf(size);
+			uint8_t* header = nullptr;
+
+			//Take a cached block of the right class, if there is one
+			{
+				std::lock_guard<std::mutex> guard(this->lock);
+				if (c != UNPOOLED && !this->freeLists[c].empty()) {
+					header = (uint8_t*)this->freeLists[c].back();
+					this->freeLists[c].pop_back();
+					this->pooled -= (size_t)1 << c;
+				}
+				this->live += size;
+			}
+
+			//Go to the heap OW
+			if (header == nullptr) {
+				size_t capacity = (c != UNPOOLED) ? (size_t)1 << c : size;
+				header = (uint8_t*)std::malloc(HEADER + capacity);
+				if (header == nullptr) {
+					std::lock_guard<std::mutex> guard(this->lock);
+					this->live -= size;
+					return nullptr;
+				}
+			}
+
+			sizeOf(header) = size;
+			classAt(header) = c;
+			return header + HEADER;
+		}
+
+		/*Resizes a block, in place when its size class still fits
+		*
+		* Returns a pointer to the resized block IFF memory is available,
+		*  nullptr OW. The original block is untouched on failure
+		*/
+		void* reallocate(void* block, size_t size) {
+			if (block == nullptr) return this->allocate(size);
+
+			uint8_t* header = headerOf(block);
+			size_t old = sizeOf(header);
+			uint32_t c = classAt(header);
+			if (c != UNPOOLED && size <= ((size_t)1 << c)) {
+				std::lock_guard<std::mutex> guard(this->lock);
+				this->live = this->live - old + size;
+				sizeOf(header) = size;
+				return block;
+			}
+
+			void* moved = this->allocate(size);
+			if (moved == nullptr) return nullptr;
+			std::memcpy(moved, block, (old < size) ? old : size);
+			this->release(block);
+			return moved;
+		}
+
+		//Frees a block, caching it for reuse while the pool has room
+		void release(void* block) {
+			if (block == nullptr) return;
+
+			uint8_t* header = headerOf(block);
+			uint32_t c = classAt(header);
+			{
+				std::lock_guard<std::mutex> guard(this->lock);
+				this->live -= sizeOf(header);
+				if (c != UNPOOLED && this->pooled + ((size_t)1 << c) <= DECODE_POOL_LIMIT) {
+					this->freeLists[c].push_back(header);
+					this->pooled += (size_t)1 << c;
+					return;
+				}
+			}
+			std::free(header);
+		}
+
+		//Returns every cached block to the heap
+		void trim() {
+			std::lock_guard<std::mutex> guard(this->lock);
+			for (uint32_t c = 0; c < MAX_CLASS; c++) {
+				for (int x = 0; x < this->freeLists[c].size(); x++)
+					std::free(this->freeLists[c][x]);
+				this->freeLists[c].clear();
+			}
+			this->pooled = 0;
+		}
+
+		//Finds the number of requested bytes handed out and not yet freed
+		size_t liveBytes() {
+			std::lock_guard<std::mutex> guard(this->lock);
+			return this->live;
+		}
+
+		//Finds the number of bytes cached for reuse
+		size_t pooledBytes() {
+			std::lock_guard<std::mutex> guard(this->lock);
+			return this->pooled;
+		}
+	};
+
+	//Accesses the process-wide decode arena. It is never destroyed, so
+	// pixels freed during static destruction still have somewhere to go
+	inline DecodeArena& decodeArena() {
+		static DecodeArena* arena = new DecodeArena();
+		return *arena;
+	}
+
+	/*The allocation hooks stb_image is built with*/
+	inline void* decodeAlloc(size_t size) { return decodeArena().allocate(size); }
+	inline void* decodeRealloc(void* block, size_t size) {
+		return decodeArena().reallocate(block, size);
+	}
+	inline void decodeFree(void* block) { decodeArena().release(block); }
+
+	/* This class owns an image decoded by stb_image and frees it when it goes
+	*   out of scope, so decoded pixels can no longer be leaked by an early
+	*   return. It can be moved but not copied.
+	*/
+	class Pixels {
+	private:
+		unsigned char* data; //The decoded pixels, nullptr if none are held
+		int width, height, bytesPerPixel;
+
+	public:
+		Pixels() {
+			this->data = nullptr;
+			this->width = 0;
+			this->height = 0;
+			this->bytesPerPixel = 0;
+		}
+
+		Pixels(Pixels&& other) {
+			this->data = other.data;
+			this->width = other.width;
+			this->height = other.height;
+			this->bytesPerPixel = other.bytesPerPixel;
+			other.data = nullptr;
+		}
+
+		Pixels& operator=(Pixels&& other) {
+			if (this != &other) {
+				this->reset();
+				this->data = other.data;
+				this->width = other.width;
+				this->height = other.height;
+				this->bytesPerPixel = other.bytesPerPixel;
+				other.data = nullptr;
+			}
+			return *this;
+		}
+
+		Pixels(const Pixels&) = delete;
+		Pixels& operator=(const Pixels&) = delete;
+
+		~Pixels() { this->reset(); }
+
+		/*Decodes an image, replacing any pixels already held
+		*
+		* Params:
+		* - path - the path to the image being decoded
+		* - channels - the number of channels to convert to, 0 keeps the
+		*   image's own
+		*
+		* Returns true IFF the image was decoded, false OW
+		*/
+		bool load(const char* path, int channels = 0) {
+			this->reset();
+			int found = 0;
+			this->data = stbi_load(path, &this->width, &this->height, &found, channels);
+			this->bytesPerPixel = (channels != 0) ? channels : found;
+			return this->data != nullptr;
+		}
+
+		//Frees the pixels held, if any
+		void reset() {
+			if (this->data != nullptr) stbi_image_free(this->data);
+			this->data = nullptr;
+			this->width = 0;
+			this->height = 0;
+			this->bytesPerPixel = 0;
+		}
+
+		//Accessors for the image
+		bool empty() const { return this->data == nullptr; }
+		unsigned char* getData() const { return this->data; }
+		int getWidth() const { return this->width; }
+		int getHeight() const { return this->height; }
+		int getBytesPerPixel() const { return this->bytesPerPixel; }
+	};
+}
+
+#endif
\ No newline at end of file
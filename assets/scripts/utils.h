@@ -7,16 +7,72 @@
 #include <fstream>
 #include <vector>
 
+#include "./pixels.h"
+
 using std::cout;
 using std::endl;
 
 //Define the utility namespace
 namespace util {
 
-	//Define global variables for screen width and height
-	static int SCREEN_WIDTH = 1080;
-	static int SCREEN_HEIGHT = 720;
+	//Define global variables for screen width and height. This is the size
+	// the window opens at and the size that GUI::Layouts are designed for;
+	// the window's current size is given by getScreenWidth/Height()
+	static const int SCREEN_WIDTH = 1080;
+	static const int SCREEN_HEIGHT = 720;
+
+	//Holds the current size of the window. Kept in a function-local static
+	// so every translation unit shares the one value
+	inline SDL_Point& screenSize() {
+		static SDL_Point size = { SCREEN_WIDTH, SCREEN_HEIGHT };
+		return size;
+	}
+
+	/*Accessors and mutator for the current size of the window. The main
+	*  loop updates it when the window is resized
+	*/
+	inline int getScreenWidth() { return screenSize().x; }
+	inline int getScreenHeight() { return screenSize().y; }
+	inline void setScreenSize(int width, int height) {
+		screenSize().x = width;
+		screenSize().y = height;
+	}
+
+	//A mouse position that stands in for the real one, see scriptMouse()
+	struct ScriptedMouse {
+		bool active;
+		int x, y;
+	};
+	inline ScriptedMouse& scriptedMouse() {
+		static ScriptedMouse mouse = { false, 0, 0 };
+		return mouse;
+	}
+
+	/*Reads the mouse position the levels act on. This is the real mouse
+	*  unless a position has been scripted, as the headless benchmark does
+	*
+	* Returns the button state, which is always 0 while scripted
+	*/
+	inline Uint32 getMouseState(int* x, int* y) {
+		ScriptedMouse& mouse = scriptedMouse();
+		if (!mouse.active) return SDL_GetMouseState(x, y);
+		if (x != nullptr) *x = mouse.x;
+		if (y != nullptr) *y = mouse.y;
+		return 0;
+	}
+
+	/*Replaces the mouse position seen by getMouseState() until
+	*  releaseMouse() is called
+	*/
+	inline void scriptMouse(int x, int y) {
+		scriptedMouse() = { true, x, y };
+	}
+	inline void releaseMouse() { scriptedMouse().active = false; }
+
+	//The color the window is cleared to behind every level
+	static const SDL_Color BACKGROUND = { 0xED, 0xDF, 0xF7, 0xFF };
 
+	//Placeholder name for unset flags and poses, interned as util::STR_ANONYMOUS
 	static std::string ANONYMOUS = "_";
 
 	/* Initializes an SDL_Window that can be displayed for the player
@@ -25,7 +81,8 @@ namespace util {
 	* - SDL Must be initialized
 	* 
 	* Postcondition:
-	* - A window is created with the provided size values, centered on screen
+	* - A resizable window is created with the provided size values, centered
+	*   on screen
 	* 
 	* Params:
 	* - caption - the name displayed for the game's window
@@ -45,7 +102,7 @@ namespace util {
 			SDL_WINDOWPOS_CENTERED,
 			SDL_WINDOWPOS_CENTERED,
 			width, height,
-			SDL_WINDOW_SHOWN
+			SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE
 		);
 
 		//If the window failed to initialize, alert the user
@@ -58,28 +115,39 @@ namespace util {
 		return window;
 	}
 
-	/* Loads an image into an SDL_Texture to be rendered to the screen
-	* 
-	* Preconditions:
-	* - SDL Must be initialized
-	* - renderer != nullptr
-	* - File must exist at the location specified by filename
-	* 
-	* Postconditions:
-	* - A texture is allocated with the image provided
-	* 
+	/* Checks whether a point falls strictly inside a rect. Empty rects
+	*   contain no points.
+	*
 	* Params:
-	* - filename - the path to the image being loaded onto the texture
-	* - renderer - a pointer to the renderer that this texture is a part of
+	* - rect - the rect being tested against
+	* - x - the x coordinate of the point
+	* - y - the y coordinate of the point
+	*
+	* Returns true IFF the point noted by (x, y) is in the rect
 	*/
-	inline SDL_Texture* LoadTexture(const char* filename, SDL_Renderer* renderer) {
-		//Store the width, height, and bytes per pixel
-		int width, height, bytesPerPixel;
-		void* data = stbi_load(filename, &width, &height, &bytesPerPixel, 0);
+	inline bool rectContains(const SDL_Rect& rect, int x, int y) {
+		if (rect.w <= 0 || rect.h <= 0) return false;
+		return x > rect.x && x < rect.x + rect.w && y > rect.y && y < rect.y + rect.h;
+	}
+
+	/* Wraps pixels decoded by stb_image in an SDL_Surface without copying
+	*   them. The surface does not own the pixels, so they must outlive it.
+	*   Creating a surface touches no renderer state, so this is safe to call
+	*   from worker threads.
+	*
+	* Params:
+	* - data - the decoded pixels, tightly packed RGB or RGBA
+	* - width - the width of the image in pixels
+	* - height - the height of the image in pixels
+	* - bytesPerPixel - 3 for RGB or 4 for RGBA
+	*
+	* Returns a pointer to the new surface IFF data != nullptr, nullptr OW
+	*/
+	inline SDL_Surface* makeSurface(void* data, int width, int height, int bytesPerPixel) {
+		if (data == nullptr) return nullptr;
 
-		//Store the image's depth
+		//Store the length of a row. stb_image packs rows without padding
 		int pitch = width * bytesPerPixel;
-		pitch = (pitch + 3) & ~3;
 
 		//Store the color channel masks, taking endianness into account
 		int32_t RMASK, GMASK, BMASK, AMASK;
@@ -95,77 +163,35 @@ namespace util {
 			AMASK = 0x000000FF;
 		#endif
 
-		//Load the surface from the data gathered from the stb_image library
-		SDL_Surface* surface = SDL_CreateRGBSurfaceFrom(
+		return SDL_CreateRGBSurfaceFrom(
 			data, width, height,
 			bytesPerPixel * 8,
 			pitch,
 			RMASK, GMASK, BMASK, AMASK);
-
-		//If the image was not properly loaded, alert the user and exit
-		if (!surface) {
-			cout << "LoadImage() failure" << endl;
-			return nullptr;
-		}
-
-		//Create the texture from the surface, then free it.
-		SDL_Texture* texture =
-			SDL_CreateTextureFromSurface(renderer, surface);
-		SDL_FreeSurface(surface);
-
-		//Return a pointer to the allocated texture
-		return texture;
 	}
 
 	/* Loads an image into an SDL_Texture to be rendered to the screen
-	*
+	* 
 	* Preconditions:
 	* - SDL Must be initialized
 	* - renderer != nullptr
 	* - File must exist at the location specified by filename
-	* - 0 <= alpha <= 255
-	*
+	* 
 	* Postconditions:
-	* - A texture is allocated with the image provided, with the opacity
-	*   adjusted based on the alpha value
-	*
+	* - A texture is allocated with the image provided
+	* 
 	* Params:
 	* - filename - the path to the image being loaded onto the texture
 	* - renderer - a pointer to the renderer that this texture is a part of
-	* - alpha - an integer that represents the opacity of the texture
 	*/
-	inline SDL_Texture* LoadTexture(
-		const char* filename, SDL_Renderer* renderer, int32_t alpha
-		) {
-		//Store the width, height, and bytes per pixel
-		int width, height, bytesPerPixel;
-		void* data = stbi_load(filename, &width, &height, &bytesPerPixel, 0);
-
-		//Store the image's depth
-		int pitch = width * bytesPerPixel;
-		pitch = (pitch + 3) & ~3;
-
-		//Store the color channel masks, taking endianness into account and
-		// preserving the opacity value provided
-		int32_t RMASK, GMASK, BMASK, AMASK;
-		#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-			RMASK = 0x000000FF;
-			GMASK = 0x0000FF00;
-			BMASK = 0x00FF0000;
-			AMASK = (bytesPerPixel == 4) ? alpha << 6 : 0;
-		#else
-			RMASK = 0xFF000000;
-			GMASK = 0x00FF0000;
-			BMASK = 0x0000FF00;
-			AMASK = alpha;
-		#endif
+	inline SDL_Texture* LoadTexture(const char* filename, SDL_Renderer* renderer) {
+		//Decode the image. The pixels are freed when this returns
+		Pixels pixels;
+		pixels.load(filename);
 
 		//Load the surface from the data gathered from the stb_image library
-		SDL_Surface* surface = SDL_CreateRGBSurfaceFrom(
-			data, width, height,
-			bytesPerPixel * 8,
-			pitch,
-			RMASK, GMASK, BMASK, AMASK);
+		SDL_Surface* surface = makeSurface(pixels.getData(),
+			pixels.getWidth(), pixels.getHeight(), pixels.getBytesPerPixel());
 
 		//If the image was not properly loaded, alert the user and exit
 		if (!surface) {
@@ -182,21 +208,75 @@ namespace util {
 		return texture;
 	}
 
-	inline std::vector<std::string> unpackState(std::string state) {
-		std::vector<std::string> textvec;
-		
-		std::string currstr = "";
-		for (char c : state) {
-			if (c != ' ')
-				currstr += c;
-			else {
-				textvec.push_back(currstr);
-				currstr = "";
+	/* Creates a copy of a texture resized to exactly width x height, so it
+	*   can be drawn without the renderer rescaling it every frame. Large
+	*   reductions are done in successive halvings, each of which averages
+	*   2x2 blocks of pixels, before a final linear pass. This avoids the
+	*   aliasing a single bilinear reduction would produce.
+	*
+	* Preconditions:
+	* - SDL Must be initialized
+	* - renderer != nullptr, src != nullptr
+	* - width > 0, height > 0
+	*
+	* Postconditions:
+	* - The renderer's target is unchanged
+	*
+	* Params:
+	* - src - the texture being resized, left unchanged
+	* - renderer - a pointer to the renderer that src is a part of
+	* - width - the width of the new texture
+	* - height - the height of the new texture
+	*
+	* Returns the resized texture IFF the renderer supports render targets,
+	*  nullptr OW
+	*/
+	inline SDL_Texture* ScaleTexture(
+		SDL_Texture* src, SDL_Renderer* renderer, int width, int height
+		) {
+		int srcW, srcH;
+		if (SDL_QueryTexture(src, NULL, NULL, &srcW, &srcH) != 0) return nullptr;
+
+		//Copy pixels across unblended and unmodulated, restoring src after
+		SDL_BlendMode blend;
+		SDL_GetTextureBlendMode(src, &blend);
+		SDL_SetTextureBlendMode(src, SDL_BLENDMODE_NONE);
+		SDL_SetTextureAlphaMod(src, 0xFF);
+		SDL_SetTextureColorMod(src, 0xFF, 0xFF, 0xFF);
+		SDL_SetTextureScaleMode(src, SDL_ScaleModeLinear);
+		SDL_Texture* target = SDL_GetRenderTarget(renderer);
+
+		SDL_Texture* curr = src;
+		while (curr != nullptr) {
+			//Halve while that stays at or above the final size
+			bool last = srcW / 2 < width || srcH / 2 < height;
+			int stepW = last ? width : srcW / 2;
+			int stepH = last ? height : srcH / 2;
+
+			SDL_Texture* next = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+				SDL_TEXTUREACCESS_TARGET, stepW, stepH);
+			if (next != nullptr && SDL_SetRenderTarget(renderer, next) != 0) {
+				SDL_DestroyTexture(next);
+				next = nullptr;
+			}
+			if (next != nullptr) {
+				SDL_SetTextureBlendMode(next, SDL_BLENDMODE_NONE);
+				SDL_SetTextureScaleMode(next, SDL_ScaleModeLinear);
+				SDL_RenderCopy(renderer, curr, NULL, NULL);
 			}
+
+			if (curr != src) SDL_DestroyTexture(curr);
+			curr = next;
+			srcW = stepW;
+			srcH = stepH;
+			if (last) break;
 		}
-		textvec.push_back(currstr);
-		
-		return textvec;
+
+		SDL_SetRenderTarget(renderer, target);
+		SDL_SetTextureBlendMode(src, blend);
+		if (curr != nullptr) SDL_SetTextureBlendMode(curr, SDL_BLENDMODE_BLEND);
+
+		return curr;
 	}
 }
 
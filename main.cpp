@@ -3,16 +3,28 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <cstring>
+#include <cstdlib>
 
 #include "./assets/scripts/utils.h"
 #include "./assets/scripts/GUI/Displayable.h"
 #include "./assets/scripts/GUI/Layering.h"
+#include "./assets/scripts/GUI/AssetLoader.h"
+#include "./assets/scripts/GUI/Archive.h"
+#include "./assets/scripts/GUI/Profiler.h"
 #include "./assets/scripts/Control/Level.h"
+#include "./assets/scripts/Control/Registry.h"
+#include "./assets/scripts/Control/LevelManager.h"
+#include "./assets/scripts/Control/Benchmark.h"
 
 using std::cout;
 using std::endl;
 
 int main(int argc, char** argv) {
+	//Benchmark the levels without a window when run as "--bench [frames]"
+	if (argc > 1 && std::strcmp(argv[1], "--bench") == 0)
+		return ctrl::runBenchmarks(argc > 2 ? std::atoi(argv[2]) : ctrl::BENCH_FRAMES);
+
 	//Create variables to store the window, its surface, and the renderer
 	SDL_Window* window = nullptr;
 	SDL_Renderer* renderer = nullptr;
@@ -30,12 +42,41 @@ int main(int argc, char** argv) {
 	renderer = SDL_CreateRenderer(window, -1, 0);
 	surface = SDL_GetWindowSurface(window);
 
-	ctrl::Level* currlvl = new ctrl::mainMenu(renderer);
+	//Layouts stay legible down to half the design size
+	SDL_SetWindowMinimumSize(window, util::SCREEN_WIDTH / 2, util::SCREEN_HEIGHT / 2);
+
+	//Serve textures from the packed archive when it has been built (see
+	// tools/assetpack.cpp), falling back to decoding the loose PNGs
+	GUI::AssetArchive* archive = new GUI::AssetArchive();
+	if (archive->open("./assets/textures.pak"))
+		GUI::AssetLoader::instance().mount(archive);
+
+	//Register the levels and open the main menu
+	ctrl::LevelRegistry::registerBuiltins();
+	ctrl::LevelManager* levels = new ctrl::LevelManager(renderer);
+	if (!levels->open(ctrl::LevelRegistry::findLevel("mainmenu"))) {
+		cout << "The main menu could not be opened" << endl;
+		cout << levels->getError() << endl;
+
+		delete levels;
+		GUI::AssetLoader::instance().shutdown();
+		GUI::AssetLoader::instance().mount(nullptr);
+		delete archive;
+		SDL_DestroyWindow(window);
+		SDL_Quit();
+		return 1;
+	}
+
+	//Time every frame. F3 toggles the overlay, F4 writes out the trace
+	GUI::Profiler& profiler = GUI::Profiler::instance();
 
 	//Create the main game loop
 	bool RUNNING = true;
 	while (RUNNING) {
+		profiler.beginFrame();
+
 		//Iterate through the list of events, handling each independently
+		profiler.beginPhase(GUI::PHASE_EVENTS);
 		SDL_Event event;
 		while (SDL_PollEvent(&event)) {
 			//Handle key presses
@@ -44,6 +85,15 @@ int main(int argc, char** argv) {
 
 				//Quit if the 'q' key is pressed
 				if (key == SDLK_q) RUNNING = false;
+
+				//Show or hide the profiler overlay
+				else if (key == SDLK_F3) profiler.toggleOverlay();
+
+				//Write the recent frames out for inspection
+				else if (key == SDLK_F4) {
+					profiler.writeCSV("./profile.csv");
+					profiler.writeTrace("./profile.json");
+				}
 			}
 
 			//Handle the window exit
@@ -51,34 +101,63 @@ int main(int argc, char** argv) {
 
 			//Handle mouse events
 			else if (event.type == SDL_MOUSEBUTTONDOWN)
-				currlvl->handleClick();
+				levels->handleClick();
+
+			//Lay the levels out again when the window changes size
+			else if (event.type == SDL_WINDOWEVENT
+				&& event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+				util::setScreenSize(event.window.data1, event.window.data2);
+				levels->resize(event.window.data1, event.window.data2);
+			}
+
+			//Redraw the render-target caches when the renderer loses them
+			else if (event.type == SDL_RENDER_TARGETS_RESET)
+				levels->resetTargets(false);
+			else if (event.type == SDL_RENDER_DEVICE_RESET)
+				levels->resetTargets(true);
 		}
 
-		currlvl->update();
+		profiler.endPhase(GUI::PHASE_EVENTS);
+
+		//Upload any textures the loader has finished decoding
+		profiler.beginPhase(GUI::PHASE_UPLOAD);
+		GUI::AssetLoader::instance().pump(renderer, GUI::UPLOADS_PER_FRAME);
+		profiler.endPhase(GUI::PHASE_UPLOAD);
+
+		profiler.beginPhase(GUI::PHASE_UPDATE);
+		levels->update();
+		profiler.endPhase(GUI::PHASE_UPDATE);
 
 		//Fill the background of the window
-		SDL_SetRenderDrawColor(renderer, 0xED, 0xDF, 0xF7, 0xFF);
+		profiler.beginPhase(GUI::PHASE_RENDER);
+		SDL_SetRenderDrawColor(renderer,
+			util::BACKGROUND.r, util::BACKGROUND.g, util::BACKGROUND.b, 0xFF);
 		SDL_RenderClear(renderer);
 
 		//Render each item in the asset list onto the render surface
-		currlvl->render();
+		levels->render();
+		profiler.endPhase(GUI::PHASE_RENDER);
+		profiler.renderOverlay(renderer);
 
 		//Render all items within the renderer to the screen
+		profiler.beginPhase(GUI::PHASE_PRESENT);
 		SDL_RenderPresent(renderer);
+		profiler.endPhase(GUI::PHASE_PRESENT);
 
-		if (currlvl->getState() == util::ANONYMOUS) continue;
-		
-		std::vector<string> newstate = util::unpackState(currlvl->getState());
-		
-		if (newstate[0] == "goto") {
-			if (newstate[1] == "gameselect") {
-				delete currlvl;
-				currlvl = new ctrl::gameSelect(renderer);
-			}
-		}
+		//Act on any transition the level has requested
+		profiler.beginPhase(GUI::PHASE_TRANSITION);
+		if (!levels->applyTransition()) RUNNING = false;
+		profiler.endPhase(GUI::PHASE_TRANSITION);
+
+		profiler.endFrame();
 	}
 
-	delete currlvl;
+	delete levels;
+
+	//Stop the decoding threads while SDL is still alive
+	GUI::AssetLoader::instance().shutdown();
+	GUI::AssetLoader::instance().mount(nullptr);
+	delete archive;
 
 	//Clean up the memory to prevent leaks
 	SDL_DestroyWindow(window);
@@ -0,0 +1,194 @@
+/* assetpack - builds the texture archive loaded by GUI::AssetArchive
+*
+*  Usage: assetpack <output> <image> [image...]
+*
+*  Every image is decoded once here, converted to SDL_PIXELFORMAT_ARGB8888
+*   (the format SDL's renderers prefer) and packed into 2048x2048 atlas
+*   pages, so the game can create textures straight from the mapped file.
+*   Images are stored under the path given on the command line, minus any
+*   leading "./", so run it from the game's root folder, e.g.
+*
+*   assetpack assets/textures.pak ./assets/texture/screens/main-menu.png ...
+*/
+#include <SDL.h>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <stdint.h>
+
+#include "../assets/dependencies/stb_image.h"
+#include "../assets/scripts/GUI/Archive.h"
+
+using std::cout;
+using std::endl;
+
+//The size of each atlas page. Larger images are given a page of their own
+static const int PAGE_SIZE = 2048;
+
+struct Image {
+	std::string name;
+	int width, height;
+	unsigned char* pixels; //RGBA, as decoded by stb_image
+	uint32_t page;
+	int x, y;
+};
+
+struct Page {
+	int width, height; //The area actually used
+	int shelfX, shelfY, shelfH; //The shelf currently being filled
+	bool closed; //Whether the page takes no more images
+};
+
+//Places an image on the open pages, opening a new one if it does not fit
+static void place(Image& img, std::vector<Page>& pages) {
+	//Oversized images get a page to themselves
+	if (img.width > PAGE_SIZE || img.height > PAGE_SIZE) {
+		pages.push_back({ img.width, img.height, 0, 0, 0, true });
+		img.page = pages.size() - 1;
+		img.x = 0;
+		img.y = 0;
+		return;
+	}
+
+	//Try the current shelf of the last page, then a new shelf below it
+	if (!pages.empty() && !pages.back().closed) {
+		Page& page = pages.back();
+		if (page.shelfX + img.width > PAGE_SIZE) {
+			page.shelfY += page.shelfH;
+			page.shelfX = 0;
+			page.shelfH = 0;
+		}
+		if (page.shelfY + img.height <= PAGE_SIZE) {
+			img.page = pages.size() - 1;
+			img.x = page.shelfX;
+			img.y = page.shelfY;
+			page.shelfX += img.width;
+			page.shelfH = std::max(page.shelfH, img.height);
+			page.width = std::max(page.width, img.x + img.width);
+			page.height = std::max(page.height, img.y + img.height);
+			return;
+		}
+	}
+
+	//Start a fresh page
+	pages.push_back({ img.width, img.height, img.width, 0, img.height, false });
+	img.page = pages.size() - 1;
+	img.x = 0;
+	img.y = 0;
+}
+
+//Writes zero bytes until the stream position is a multiple of align
+static void pad(std::ofstream& out, uint64_t align) {
+	static const char zeros[GUI::ARCHIVE_ALIGN] = { 0 };
+	uint64_t at = (uint64_t)out.tellp();
+	uint64_t extra = (align - at % align) % align;
+	out.write(zeros, extra);
+}
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		cout << "Usage: assetpack <output> <image> [image...]" << endl;
+		return 1;
+	}
+
+	//Decode every image to RGBA
+	std::vector<Image> images;
+	for (int x = 2; x < argc; x++) {
+		Image img;
+		img.name = argv[x];
+		if (img.name.compare(0, 2, "./") == 0) img.name = img.name.substr(2);
+		if (img.name.size() >= GUI::ARCHIVE_NAME_LEN) {
+			cout << "Path too long: " << argv[x] << endl;
+			return 1;
+		}
+
+		int channels;
+		img.pixels = stbi_load(argv[x], &img.width, &img.height, &channels, 4);
+		if (img.pixels == nullptr) {
+			cout << "Cannot decode " << argv[x] << ": " << stbi_failure_reason() << endl;
+			return 1;
+		}
+		images.push_back(img);
+	}
+
+	//Pack the tallest images first, which keeps the shelves tight
+	std::vector<Image*> order;
+	for (int x = 0; x < images.size(); x++) order.push_back(&images[x]);
+	std::stable_sort(order.begin(), order.end(), [](const Image* a, const Image* b) {
+		return a->height > b->height;
+	});
+	std::vector<Page> pages;
+	for (int x = 0; x < order.size(); x++) place(*order[x], pages);
+
+	//Lay out the file: tables first, then each page on an aligned offset
+	GUI::ArchiveHeader header;
+	std::memcpy(header.magic, GUI::ARCHIVE_MAGIC, 4);
+	header.version = GUI::ARCHIVE_VERSION;
+	header.pixelFormat = SDL_PIXELFORMAT_ARGB8888;
+	header.pageCount = pages.size();
+	header.entryCount = images.size();
+	header.reserved = 0;
+
+	uint64_t offset = sizeof(header)
+		+ pages.size() * sizeof(GUI::ArchivePage)
+		+ images.size() * sizeof(GUI::ArchiveEntry);
+	std::vector<GUI::ArchivePage> table;
+	for (int x = 0; x < pages.size(); x++) {
+		offset = (offset + GUI::ARCHIVE_ALIGN - 1) / GUI::ARCHIVE_ALIGN * GUI::ARCHIVE_ALIGN;
+		GUI::ArchivePage page;
+		page.width = pages[x].width;
+		page.height = pages[x].height;
+		page.pitch = page.width * 4;
+		page.reserved = 0;
+		page.offset = offset;
+		table.push_back(page);
+		offset += (uint64_t)page.pitch * page.height;
+	}
+
+	std::ofstream out(argv[1], std::ios::binary);
+	if (!out) {
+		cout << "Cannot write " << argv[1] << endl;
+		return 1;
+	}
+	out.write((const char*)&header, sizeof(header));
+	out.write((const char*)table.data(), table.size() * sizeof(GUI::ArchivePage));
+	for (int x = 0; x < images.size(); x++) {
+		GUI::ArchiveEntry entry;
+		std::memset(&entry, 0, sizeof(entry));
+		std::strncpy(entry.name, images[x].name.c_str(), GUI::ARCHIVE_NAME_LEN - 1);
+		entry.page = images[x].page;
+		entry.x = images[x].x;
+		entry.y = images[x].y;
+		entry.w = images[x].width;
+		entry.h = images[x].height;
+		out.write((const char*)&entry, sizeof(entry));
+	}
+
+	//Convert each page's images to ARGB8888 and write the pixels out
+	for (uint32_t p = 0; p < pages.size(); p++) {
+		std::vector<uint32_t> pixels((size_t)table[p].width * table[p].height, 0);
+		for (int x = 0; x < images.size(); x++) {
+			const Image& img = images[x];
+			if (img.page != p) continue;
+			for (int row = 0; row < img.height; row++) {
+				const unsigned char* src = img.pixels + (size_t)row * img.width * 4;
+				uint32_t* dst = &pixels[(size_t)(img.y + row) * table[p].width + img.x];
+				for (int col = 0; col < img.width; col++, src += 4)
+					dst[col] = ((uint32_t)src[3] << 24) | ((uint32_t)src[0] << 16)
+						| ((uint32_t)src[1] << 8) | (uint32_t)src[2];
+			}
+		}
+		pad(out, GUI::ARCHIVE_ALIGN);
+		out.write((const char*)pixels.data(), pixels.size() * 4);
+	}
+	pad(out, GUI::ARCHIVE_ALIGN);
+
+	for (int x = 0; x < images.size(); x++) stbi_image_free(images[x].pixels);
+
+	cout << "Packed " << images.size() << " images into " << pages.size();
+	cout << " pages (" << (uint64_t)out.tellp() << " bytes)" << endl;
+	return 0;
+}
\ No newline at end of file
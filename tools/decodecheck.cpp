@@ -0,0 +1,119 @@
+/* decodecheck - checks that decoding images leaks no pixel memory
+*
+*  Usage: decodecheck <rounds> <image> [image...]
+*
+*  Every round loads each image twice: synchronously through
+*   util::LoadTexture(), then through the AssetLoader's workers into a
+*   Displayable. Once the textures are destroyed, no decoded pixels may be
+*   left alive in util::DecodeArena, and the bytes it caches for reuse must
+*   match those cached after the first round, as later rounds should be
+*   served entirely from the pool. Exits with 1 IFF either check fails.
+*
+*  Textures are made by a software renderer, so no window is needed. Run it
+*   from the game's root folder, e.g.
+*
+*   decodecheck 20 ./assets/texture/screens/main-menu.png ...
+*/
+#include <SDL.h>
+#include <iostream>
+#include <cstdlib>
+#include <stdint.h>
+
+#include "../assets/scripts/utils.h"
+#include "../assets/scripts/pixels.h"
+#include "../assets/scripts/GUI/Displayable.h"
+#include "../assets/scripts/GUI/AssetLoader.h"
+
+using std::cout;
+using std::endl;
+
+//The most pumps spent waiting for the workers before a request is abandoned
+static const int PUMP_LIMIT = 10000;
+
+//Loads an image through util::LoadTexture(). Returns true IFF it loaded
+static bool loadDirect(SDL_Renderer* renderer, const char* path) {
+	SDL_Texture* texture = util::LoadTexture(path, renderer);
+	if (texture == nullptr) return false;
+	SDL_DestroyTexture(texture);
+	return true;
+}
+
+/*Loads an image through the AssetLoader and waits for it to be delivered.
+*  One request is in flight at a time so that every round decodes with the
+*  same buffers alive, keeping the pool's size comparable between rounds.
+*
+* Returns true IFF it loaded
+*/
+static bool loadQueued(SDL_Renderer* renderer, const char* path) {
+	GUI::AssetLoader& loader = GUI::AssetLoader::instance();
+	GUI::Displayable* target = new GUI::Displayable();
+	target->loadTexture(path);
+
+	for (int x = 0; x < PUMP_LIMIT && loader.pending() > 0; x++) {
+		if (loader.pump(renderer, GUI::UPLOADS_PER_FRAME) == 0) SDL_Delay(1);
+	}
+
+	bool loaded = target->hasTexture();
+	delete target;
+	return loaded;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 3 || std::atoi(argv[1]) <= 0) {
+		cout << "Usage: decodecheck <rounds> <image> [image...]" << endl;
+		return 1;
+	}
+	int rounds = std::atoi(argv[1]);
+
+	if (SDL_Init(SDL_INIT_TIMER) < 0) {
+		cout << "SDL could not initialize" << endl;
+		cout << SDL_GetError() << endl;
+		return 1;
+	}
+	SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+	SDL_Renderer* renderer = (target != nullptr) ? SDL_CreateSoftwareRenderer(target) : nullptr;
+	if (renderer == nullptr) {
+		cout << "Software renderer could not be created" << endl;
+		cout << SDL_GetError() << endl;
+		if (target != nullptr) SDL_FreeSurface(target);
+		SDL_Quit();
+		return 1;
+	}
+
+	util::DecodeArena& arena = util::decodeArena();
+	size_t pooled = 0;
+	bool passed = true;
+	for (int round = 0; round < rounds && passed; round++) {
+		for (int x = 2; x < argc; x++) {
+			if (!loadDirect(renderer, argv[x]) || !loadQueued(renderer, argv[x])) {
+				cout << "Round " << round << ": " << argv[x] << " could not be loaded" << endl;
+				passed = false;
+			}
+		}
+
+		size_t live = arena.liveBytes();
+		if (live != 0) {
+			cout << "Round " << round << ": " << live << " decoded bytes still alive" << endl;
+			passed = false;
+		}
+
+		//The first round fills the pool, later ones must only reuse it
+		if (round == 0) pooled = arena.pooledBytes();
+		else if (arena.pooledBytes() != pooled) {
+			cout << "Round " << round << ": pool grew from " << pooled;
+			cout << " to " << arena.pooledBytes() << " bytes" << endl;
+			passed = false;
+		}
+	}
+	if (passed) {
+		cout << rounds << " rounds passed, " << pooled << " bytes pooled" << endl;
+	}
+
+	//Stop the decoding threads while SDL is still alive
+	GUI::AssetLoader::instance().shutdown();
+	SDL_DestroyRenderer(renderer);
+	SDL_FreeSurface(target);
+	SDL_Quit();
+
+	return passed ? 0 : 1;
+}